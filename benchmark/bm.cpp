@@ -11,6 +11,7 @@
 #include "decoder_context.hpp"
 #include "octet_encoder.hpp"
 #include "octet_decoder.hpp"
+#include "batch.hpp"
 
 namespace {
 
@@ -116,6 +117,27 @@ void BM_encode_fail(benchmark::State& state)
 }
 BENCHMARK(BM_encode_fail);
 
+void BM_encode_fail_status(benchmark::State& state)
+{
+	PROTO proto;
+	uint8_t buffer[1024];
+	med::encoder_context<> ctx{ buffer };
+
+	auto& msg = proto.ref<MSG_SEQ>();
+	msg.ref<FLD_UC>().set(0);
+	msg.ref<FLD_U24>().set(0);
+
+	while (state.KeepRunning())
+	{
+		ctx.reset();
+		if (encode(med::octet_encoder{ctx, med::status_on_error{}}, proto).code() != med::error::missing_ie)
+		{
+			std::abort();
+		}
+	}
+}
+BENCHMARK(BM_encode_fail_status);
+
 void BM_decode_ok(benchmark::State& state)
 {
 	PROTO proto;
@@ -173,6 +195,284 @@ void BM_decode_fail(benchmark::State& state)
 }
 BENCHMARK(BM_decode_fail);
 
+void BM_decode_fail_status(benchmark::State& state)
+{
+	PROTO proto;
+	med::decoder_context<> ctx;
+
+	//invalid length of variable field (longer)
+	uint8_t const bad_var_len_hi[] = { 1
+		, 37
+		, 0x21, 0x35, 0xD9
+		, 3, 0xDA, 0xBE, 0xEF
+		, 0x42, 4, 0xFE, 0xE1, 0xAB, 0xBA
+		, 0x12, 5, 't', 'e', 's', 't', 'e', 's', 't', 'e', 's', 't', 'e'
+	};
+
+	while (state.KeepRunning())
+	{
+		ctx.reset(bad_var_len_hi, sizeof(bad_var_len_hi));
+		if (decode(med::octet_decoder{ctx, med::status_on_error{}}, proto))
+		{
+			std::printf("SHOULD NOT REACH HERE!\n");
+			std::abort();
+		}
+	}
+}
+BENCHMARK(BM_decode_fail_status);
+
+//length-framed message
+using L16 = med::length_t<med::value<uint16_t>>;
+struct FRAMED : med::sequence<
+	M< L16, PROTO >
+>
+{
+};
+using framing = med::length_framing<0, med::value<uint16_t>>;
+
+//back-to-back frames as received from socket
+struct frames
+{
+	static constexpr std::size_t NUM = 100;
+	static constexpr uint8_t encoded[] = { 0, 32, 1
+		, 37
+		, 0x21, 0x35, 0xD9
+		, 3, 0xDA, 0xBE, 0xEF
+		, 0x42, 4, 0xFE, 0xE1, 0xAB, 0xBA
+		, 0x51, 0x01, 0x02, 0x03, 0x04
+		, 0x12, 4, 't', 'e', 's', 't', '.', 't', 'h', 'i', 's', '!'
+	};
+
+	frames()
+	{
+		for (std::size_t i = 0; i < NUM; ++i) { std::memcpy(data + i * sizeof(encoded), encoded, sizeof(encoded)); }
+	}
+
+	uint8_t data[NUM * sizeof(encoded)];
+};
+
+void BM_decode_loop(benchmark::State& state)
+{
+	frames const input;
+	FRAMED msg;
+
+	std::size_t dummy = 0;
+	while (state.KeepRunning())
+	{
+		uint8_t const* p = input.data;
+		std::size_t left = sizeof(input.data);
+		while (auto const size = framing::frame_size(p, left))
+		{
+			med::decoder_context<> ctx{p, size};
+			if (decode(med::octet_decoder{ctx, med::status_on_error{}}, msg))
+			{
+				dummy += msg.get<PROTO>().get<MSG_SEQ>()->get<FLD_UC>().get();
+			}
+			p += size;
+			left -= size;
+		}
+		benchmark::DoNotOptimize(dummy);
+	}
+	state.SetItemsProcessed(state.iterations() * frames::NUM);
+}
+BENCHMARK(BM_decode_loop);
+
+void BM_decode_batch(benchmark::State& state)
+{
+	frames const input;
+	FRAMED msg;
+	med::decoder_context<> ctx;
+
+	std::size_t dummy = 0;
+	while (state.KeepRunning())
+	{
+		med::decode_batch<framing>(med::octet_decoder{ctx, med::status_on_error{}}, input.data, msg
+			, [&dummy](FRAMED const& m, med::status const& st)
+		{
+			if (st) { dummy += m.get<PROTO>().get<MSG_SEQ>()->get<FLD_UC>().get(); }
+		});
+		benchmark::DoNotOptimize(dummy);
+	}
+	state.SetItemsProcessed(state.iterations() * frames::NUM);
+}
+BENCHMARK(BM_decode_batch);
+
+//GTPv2-C like message with many IEs
+namespace gtpc {
+
+struct length : med::value<uint16_t> {};
+using L16 = med::length_t<length>;
+template <uint8_t TYPE> using IE_TYPE = med::value<med::fixed<TYPE, uint8_t>>;
+
+struct spare_instance : med::value<uint8_t> {};
+
+//IE value preceded by spare/instance octet
+template <uint8_t TYPE, class VALUE = med::octet_string<>>
+struct ie : med::sequence<
+	M< spare_instance >,
+	M< VALUE >
+>
+{
+};
+template <uint8_t TYPE, class VALUE = med::octet_string<>>
+using TLIV = M< IE_TYPE<TYPE>, L16, ie<TYPE, VALUE> >;
+template <uint8_t TYPE, class VALUE = med::octet_string<>>
+using OTLIV = O< IE_TYPE<TYPE>, L16, ie<TYPE, VALUE> >;
+
+struct bearer_ies : med::set<
+	TLIV< 73, med::value<uint8_t> >, //EBI
+	TLIV< 80 >,                      //Bearer QoS
+	O< IE_TYPE<87>, L16, ie<87>, med::max<4> > //F-TEID
+>
+{
+};
+
+struct create_session_request : med::set<
+	OTLIV< 1 >,   //IMSI
+	OTLIV< 76 >,  //MSISDN
+	OTLIV< 75 >,  //MEI
+	OTLIV< 86 >,  //ULI
+	OTLIV< 83 >,  //Serving Network
+	TLIV< 82, med::value<uint8_t> >,  //RAT Type
+	OTLIV< 77 >,  //Indication
+	TLIV< 87 >,   //Sender F-TEID
+	TLIV< 71 >,   //APN
+	OTLIV< 128, med::value<uint8_t> >, //Selection Mode
+	OTLIV< 99, med::value<uint8_t> >,  //PDN Type
+	OTLIV< 79 >,  //PAA
+	OTLIV< 127, med::value<uint8_t> >, //APN Restriction
+	OTLIV< 72, med::value<uint64_t> >, //AMBR
+	OTLIV< 3, med::value<uint8_t> >,   //Recovery
+	OTLIV< 114 >, //UE Time Zone
+	OTLIV< 95, med::value<uint16_t> >, //Charging Characteristics
+	M< IE_TYPE<93>, L16, ie<93, bearer_ies>, med::max<11> > //Bearer Context
+>
+{
+};
+
+struct create_session_response : med::set<
+	TLIV< 2, med::value<uint16_t> >,   //Cause
+	OTLIV< 87 >   //F-TEID
+>
+{
+};
+
+struct message : med::choice<
+	M< IE_TYPE<32>, L16, create_session_request >,
+	M< IE_TYPE<33>, L16, create_session_response >
+>
+{
+};
+
+template <uint8_t TYPE, class MSG>
+void set_ie(MSG& msg, char const* value)
+{
+	auto& v = msg.template ref<ie<TYPE>>();
+	v.template ref<spare_instance>().set(0);
+	v.template ref<med::octet_string<>>().set(std::strlen(value), value);
+}
+
+template <uint8_t TYPE, class VALUE, class MSG>
+void set_ie(MSG& msg, typename VALUE::value_type value)
+{
+	auto& v = msg.template ref<ie<TYPE, VALUE>>();
+	v.template ref<spare_instance>().set(0);
+	v.template ref<VALUE>().set(value);
+}
+
+struct encoded
+{
+	encoded()
+	{
+		message proto;
+		auto& msg = proto.ref<create_session_request>();
+		set_ie<1>(msg, "\x21\x43\x65\x87\x09\x21\x43\xF5");
+		set_ie<76>(msg, "\x21\x43\x65\x87\x09\x21");
+		set_ie<75>(msg, "\x53\x71\x82\x00\x11\x22\x33\x44");
+		set_ie<86>(msg, "\x18\x52\xF0\x10\x00\x01\x52\xF0\x10\x00\x00\x00\x01");
+		set_ie<83>(msg, "\x52\xF0\x10");
+		set_ie<82, med::value<uint8_t>>(msg, 6);
+		set_ie<77>(msg, "\x00\x08\x00");
+		set_ie<87>(msg, "\x8A\x00\x00\x00\x01\x0A\x01\x02\x03");
+		set_ie<71>(msg, "\x08internet\x03mnc001\x03mcc001\x04gprs");
+		set_ie<128, med::value<uint8_t>>(msg, 0);
+		set_ie<99, med::value<uint8_t>>(msg, 1);
+		set_ie<79>(msg, "\x01\x00\x00\x00\x00");
+		set_ie<127, med::value<uint8_t>>(msg, 0);
+		set_ie<72, med::value<uint64_t>>(msg, 0x0000100000001000);
+		set_ie<3, med::value<uint8_t>>(msg, 7);
+		set_ie<114>(msg, "\x40\x00");
+		set_ie<95, med::value<uint16_t>>(msg, 0x0800);
+		for (uint8_t ebi = 5; ebi < 8; ++ebi)
+		{
+			auto* bc = msg.ref<ie<93, bearer_ies>>().push_back();
+			bc->ref<spare_instance>().set(0);
+			auto& bies = bc->ref<bearer_ies>();
+			set_ie<73, med::value<uint8_t>>(bies, ebi);
+			set_ie<80>(bies, "\x09\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00");
+		}
+
+		med::encoder_context<> ctx{ data };
+		encode(med::octet_encoder{ctx}, proto);
+		size = ctx.buffer().get_offset();
+	}
+
+	uint8_t     data[512];
+	std::size_t size;
+};
+
+} //end: namespace gtpc
+
+//decode into the same message object again and again
+void BM_gtpc_decode_reuse(benchmark::State& state)
+{
+	gtpc::encoded const input;
+	gtpc::message proto;
+	med::decoder_context<> ctx;
+
+	std::size_t dummy = 0;
+	while (state.KeepRunning())
+	{
+		ctx.reset(input.data, input.size);
+		decode(med::octet_decoder{ctx}, proto);
+		dummy += proto.get<gtpc::create_session_request>()->count<gtpc::ie<93, gtpc::bearer_ies>>();
+		benchmark::DoNotOptimize(dummy);
+	}
+}
+BENCHMARK(BM_gtpc_decode_reuse);
+
+//cost of clearing decoded message by visiting its IEs before re-selection
+void BM_gtpc_clear(benchmark::State& state)
+{
+	gtpc::encoded const input;
+	gtpc::message proto;
+	med::decoder_context<> ctx{input.data, input.size};
+	decode(med::octet_decoder{ctx}, proto);
+
+	while (state.KeepRunning())
+	{
+		proto.clear();
+		benchmark::DoNotOptimize(proto.ref<gtpc::create_session_request>());
+	}
+}
+BENCHMARK(BM_gtpc_clear);
+
+//cost of resetting decoded message w/o visiting its IEs before re-selection
+void BM_gtpc_reset(benchmark::State& state)
+{
+	gtpc::encoded const input;
+	gtpc::message proto;
+	med::decoder_context<> ctx{input.data, input.size};
+	decode(med::octet_decoder{ctx}, proto);
+
+	while (state.KeepRunning())
+	{
+		proto.reset();
+		benchmark::DoNotOptimize(proto.ref<gtpc::create_session_request>());
+	}
+}
+BENCHMARK(BM_gtpc_reset);
+
 } //end: namespace
 
 BENCHMARK_MAIN();
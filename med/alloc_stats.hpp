@@ -0,0 +1,134 @@
+/**
+@file
+allocator wrapper collecting allocation statistics per message type
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <string_view>
+#include <vector>
+
+#include "allocator.hpp"
+#include "choice.hpp"
+#include "name.hpp"
+
+namespace med {
+
+namespace sl {
+
+//name of the selected case of choice
+struct choice_case_name : choice_if
+{
+	template <class IE, class TO>
+	static constexpr char const* apply(TO const&)   { return name<get_field_type_t<IE>>(); }
+
+	template <class TO>
+	static constexpr char const* apply(TO const&)   { return name<TO>(); }
+};
+
+} //end: namespace sl
+
+//allocation statistics of a message type
+struct alloc_stats
+{
+	static constexpr std::size_t num_buckets = 32;
+
+	std::string_view name;         //of the message type
+	std::size_t      messages;     //number of messages recorded
+	std::size_t      allocations;  //total number of allocations
+	std::size_t      peak_bytes;   //max bytes allocated for a message
+	std::size_t      peak_count;   //max number of allocations for a message
+	//number of messages by bytes allocated: [0] - none, [N] - less than 2^N bytes
+	std::array<std::size_t, num_buckets> histogram;
+
+	static constexpr std::size_t bucket(std::size_t bytes)
+	{
+		return std::min<std::size_t>(std::bit_width(bytes), num_buckets - 1);
+	}
+};
+
+/**
+ * Instrumented allocator recording the high-water-mark of allocations
+ * @details Allocations are accounted to current message until commit()
+ * which records them under the name of the message type (or the selected
+ * case of choice) to be exported by snapshot() and sizing the allocators.
+ */
+template <AAllocator ALLOCATOR>
+class stats_allocator
+{
+public:
+	explicit stats_allocator(ALLOCATOR& alloc) noexcept : m_alloc{alloc} {}
+
+	stats_allocator(stats_allocator const&) = delete;
+	stats_allocator& operator=(stats_allocator const&) = delete;
+
+	[[nodiscard]]
+	void* allocate(std::size_t bytes, std::size_t alignment)
+	{
+		void* p = m_alloc.allocate(bytes, alignment);
+		if (p)
+		{
+			m_bytes += bytes;
+			++m_count;
+		}
+		return p;
+	}
+
+	ALLOCATOR& get_allocator() noexcept           { return m_alloc; }
+
+	//bytes and allocations of current message
+	std::size_t bytes() const noexcept            { return m_bytes; }
+	std::size_t count() const noexcept            { return m_count; }
+
+	//records allocations of the current message
+	template <AHasIeType IE>
+	void commit(IE const& ie)
+	{
+		if constexpr (std::is_same_v<typename IE::ie_type, IE_CHOICE>)
+		{
+			commit(meta::for_if<typename IE::ies_types>(sl::choice_case_name{}, ie));
+		}
+		else
+		{
+			commit(name<IE>());
+		}
+	}
+
+	void commit(std::string_view msg_name)
+	{
+		auto it = std::find_if(m_stats.begin(), m_stats.end(), [msg_name](auto const& s) { return s.name == msg_name; });
+		if (it == m_stats.end())
+		{
+			it = m_stats.insert(it, alloc_stats{msg_name, 0, 0, 0, 0, {}});
+		}
+		++it->messages;
+		it->allocations += m_count;
+		it->peak_bytes = std::max(it->peak_bytes, m_bytes);
+		it->peak_count = std::max(it->peak_count, m_count);
+		++it->histogram[alloc_stats::bucket(m_bytes)];
+		m_bytes = m_count = 0;
+	}
+
+	std::vector<alloc_stats> snapshot() const     { return m_stats; }
+	alloc_stats const* find(std::string_view msg_name) const
+	{
+		auto it = std::find_if(m_stats.begin(), m_stats.end(), [msg_name](auto const& s) { return s.name == msg_name; });
+		return it != m_stats.end() ? &*it : nullptr;
+	}
+	void reset()                                  { m_stats.clear(); m_bytes = m_count = 0; }
+
+private:
+	ALLOCATOR&               m_alloc;
+	std::size_t              m_bytes {0};
+	std::size_t              m_count {0};
+	std::vector<alloc_stats> m_stats;
+};
+
+} //end: namespace med
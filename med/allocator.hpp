@@ -20,20 +20,38 @@ namespace med {
 struct null_allocator
 {
 	[[nodiscard]]
-	void* allocate(std::size_t bytes, std::size_t /*alignment*/) const
+	void* allocate(std::size_t /*bytes*/, std::size_t /*alignment*/) const noexcept
 	{
 		CODEC_TRACE("%s", __FUNCTION__);
-		MED_THROW_EXCEPTION(out_of_memory, __FUNCTION__, bytes);
+		return nullptr;
 	}
 };
 
+//same as create but returns nullptr when out of space
 template <typename T, class ALLOCATOR, class... ARGs>
-T* create(ALLOCATOR& alloc, ARGs&&... args)
+T* try_create(ALLOCATOR& alloc, ARGs&&... args)
 {
 	CODEC_TRACE("%s", __FUNCTION__);
 	void* p = alloc.allocate(sizeof(T), alignof(T));
+	return p ? new (p) T{std::forward<ARGs>(args)...} : nullptr;
+}
+
+//same as try_create but for array of default constructed items
+template <typename T, class ALLOCATOR>
+T* try_create_n(ALLOCATOR& alloc, std::size_t num)
+{
+	CODEC_TRACE("%s(%zu)", __FUNCTION__, num);
+	void* p = alloc.allocate(sizeof(T) * num, alignof(T));
+	if (p) { std::uninitialized_value_construct_n(static_cast<T*>(p), num); }
+	return static_cast<T*>(p);
+}
+
+template <typename T, class ALLOCATOR, class... ARGs>
+T* create(ALLOCATOR& alloc, ARGs&&... args)
+{
+	T* p = try_create<T>(alloc, std::forward<ARGs>(args)...);
 	if (!p) { MED_THROW_EXCEPTION(out_of_memory, name<T>(), sizeof(T)); }
-	return new (p) T{std::forward<ARGs>(args)...};
+	return p;
 }
 
 namespace detail {
@@ -0,0 +1,294 @@
+/**
+@file
+arena allocator of chained blocks from thread-local pool
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+#include "debug.hpp"
+
+namespace med {
+
+namespace detail {
+
+//header of memory block followed by its data
+struct arena_block
+{
+	arena_block* next;
+	std::size_t  size; //of data
+	std::size_t  mapped; //total size of mapping
+	bool         pooled; //returned to pool when arena is destroyed
+
+	uint8_t* data() noexcept                  { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+//thread-local pool of blocks released by arenas
+class arena_pool
+{
+public:
+	//default limit of mapped bytes kept in the pool
+	static constexpr std::size_t DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+	arena_pool() = default;
+	arena_pool(arena_pool const&) = delete;
+	arena_pool& operator=(arena_pool const&) = delete;
+	~arena_pool()                             { shrink(0); }
+
+	static arena_pool& instance()
+	{
+		static thread_local arena_pool pool;
+		return pool;
+	}
+
+	//1st fit of the released blocks
+	arena_block* acquire(std::size_t size) noexcept
+	{
+		for (arena_block** pp = &m_free; *pp; pp = &(*pp)->next)
+		{
+			if ((*pp)->size >= size)
+			{
+				auto* b = *pp;
+				*pp = b->next;
+				--m_count;
+				m_size -= b->mapped;
+				b->next = nullptr;
+				return b;
+			}
+		}
+		return nullptr;
+	}
+
+	//keeps the block unless the pool is full
+	void put(arena_block* b) noexcept
+	{
+		if (m_size + b->mapped > m_max_size)
+		{
+			::munmap(b, b->mapped);
+			return;
+		}
+		b->next = m_free;
+		m_free = b;
+		++m_count;
+		m_size += b->mapped;
+	}
+
+	//unmaps the blocks until the pool holds at most given number of bytes
+	void shrink(std::size_t keep) noexcept
+	{
+		while (m_free && m_size > keep)
+		{
+			auto* b = m_free;
+			m_free = b->next;
+			--m_count;
+			m_size -= b->mapped;
+			::munmap(b, b->mapped);
+		}
+	}
+
+	std::size_t count() const noexcept        { return m_count; }
+	std::size_t size() const noexcept         { return m_size; }
+	std::size_t max_size() const noexcept     { return m_max_size; }
+	void max_size(std::size_t v) noexcept     { m_max_size = v; shrink(v); }
+
+private:
+	arena_block* m_free {nullptr};
+	std::size_t  m_count {0};
+	std::size_t  m_size {0}; //mapped bytes of the blocks in pool
+	std::size_t  m_max_size {DEFAULT_MAX_SIZE};
+};
+
+} //end: namespace detail
+
+/**
+ * Allocator of chained blocks with O(1) release
+ * @details When current block is exhausted the allocation falls back to the
+ * next block of the chain which is taken from thread-local pool or mapped.
+ * The release keeps the blocks to be reused by the next allocations while
+ * destruction returns them to the pool of the thread. The pool keeps up to
+ * pool_limit() bytes (the excess is unmapped) and can be shrunk explicitly.
+ * Huge page blocks are mapped at 2MB boundary to be fully backed by THP.
+ * NOTE: arena has to be destroyed in the thread it was used.
+ */
+class arena
+{
+public:
+	enum class pages
+	{
+		REGULAR,   //regular pages
+		THP,       //transparent huge pages (advised)
+		HUGETLB,   //explicit huge pages if available, THP otherwise
+	};
+
+	static constexpr std::size_t huge_page = 2 * 1024 * 1024;
+
+	explicit arena(std::size_t block_size = 64 * 1024, pages backing = pages::REGULAR) noexcept
+		: m_block_size{block_size}, m_backing{backing}
+	{ }
+
+	arena(arena const&) = delete;
+	arena& operator=(arena const&) = delete;
+	~arena()                                  { free(); }
+
+	/**
+	 * Allocates from the current block or falls back to the next one
+	 * @return pointer to allocated space or nullptr when can't map new block
+	 */
+	[[nodiscard]]
+	void* allocate(std::size_t bytes, std::size_t alignment) noexcept
+	{
+		if (m_curr)
+		{
+			if (void* p = bump(bytes, alignment)) { return p; }
+			//try next blocks of the chain left after release
+			while (m_curr->next)
+			{
+				m_curr = m_curr->next;
+				m_begin = m_curr->data();
+				m_end = m_begin + m_curr->size;
+				if (void* p = bump(bytes, alignment)) { return p; }
+			}
+		}
+
+		auto* b = new_block(bytes + alignment);
+		if (!b) { return nullptr; }
+		if (m_curr) { m_curr->next = b; }
+		else { m_head = b; }
+		m_curr = b;
+		m_begin = b->data();
+		m_end = m_begin + b->size;
+		return bump(bytes, alignment);
+	}
+
+	/**
+	 * Releases all allocations keeping the blocks for reuse
+	 */
+	void release() noexcept
+	{
+		m_curr = m_head;
+		if (m_curr)
+		{
+			m_begin = m_curr->data();
+			m_end = m_begin + m_curr->size;
+		}
+	}
+
+	/**
+	 * Returns all blocks to the pool of the thread
+	 */
+	void free() noexcept
+	{
+		auto& pool = detail::arena_pool::instance();
+		while (m_head)
+		{
+			auto* b = m_head;
+			m_head = b->next;
+			if (b->pooled) { pool.put(b); }
+			else { ::munmap(b, b->mapped); }
+		}
+		m_curr = nullptr;
+		m_begin = m_end = nullptr;
+	}
+
+	//bytes kept in the pool of the thread
+	static std::size_t pool_size() noexcept   { return detail::arena_pool::instance().size(); }
+	static std::size_t pool_limit() noexcept  { return detail::arena_pool::instance().max_size(); }
+	//sets the limit of the pool of the thread unmapping the excess
+	static void pool_limit(std::size_t bytes) noexcept { detail::arena_pool::instance().max_size(bytes); }
+	//unmaps the pooled blocks of the thread until at most given bytes are kept
+	static void shrink_pool(std::size_t keep = 0) noexcept { detail::arena_pool::instance().shrink(keep); }
+
+	std::size_t block_size() const noexcept   { return m_block_size; }
+	std::size_t num_blocks() const noexcept
+	{
+		std::size_t num = 0;
+		for (auto* b = m_head; b; b = b->next) { ++num; }
+		return num;
+	}
+
+private:
+	void* bump(std::size_t bytes, std::size_t alignment) noexcept
+	{
+		auto const addr = reinterpret_cast<uintptr_t>(m_begin);
+		auto const aligned = (addr - 1u + alignment) & -alignment;
+		if (aligned + bytes <= reinterpret_cast<uintptr_t>(m_end))
+		{
+			m_begin = reinterpret_cast<uint8_t*>(aligned + bytes);
+			return reinterpret_cast<void*>(aligned);
+		}
+		return nullptr;
+	}
+
+	static void* map(std::size_t size, int flags) noexcept
+	{
+		void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+		return p == MAP_FAILED ? nullptr : p;
+	}
+
+	//maps with extra alignment unmapping the excess around
+	static void* map_aligned(std::size_t size, std::size_t alignment) noexcept
+	{
+		void* p = map(size + alignment, 0);
+		if (!p) { return nullptr; }
+		auto const addr = reinterpret_cast<uintptr_t>(p);
+		auto const aligned = (addr - 1u + alignment) & -alignment;
+		if (auto const head = aligned - addr) { ::munmap(p, head); }
+		if (auto const tail = addr + alignment - aligned) { ::munmap(reinterpret_cast<void*>(aligned + size), tail); }
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	detail::arena_block* new_block(std::size_t min_size) noexcept
+	{
+		//blocks of regular size are pooled while bigger ones are mapped on demand
+		bool const pooled = min_size <= m_block_size;
+		std::size_t const size = pooled ? m_block_size : min_size;
+		if (pooled)
+		{
+			if (auto* b = detail::arena_pool::instance().acquire(size)) { return b; }
+		}
+
+		std::size_t const granularity = (m_backing == pages::REGULAR) ? 4096 : huge_page;
+		std::size_t const mapped = (size + sizeof(detail::arena_block) + granularity - 1) / granularity * granularity;
+		void* p = nullptr;
+#ifdef MAP_HUGETLB
+		if (m_backing == pages::HUGETLB) { p = map(mapped, MAP_HUGETLB); }
+#endif
+		if (!p)
+		{
+			if (m_backing == pages::REGULAR) { p = map(mapped, 0); }
+			else
+			{
+				//THP backs only aligned huge pages
+				p = map_aligned(mapped, huge_page);
+#ifdef MADV_HUGEPAGE
+				if (p) { ::madvise(p, mapped, MADV_HUGEPAGE); }
+#endif
+			}
+		}
+		if (!p)
+		{
+			CODEC_TRACE("%s: failed to map %zu bytes", __FUNCTION__, mapped);
+			return nullptr;
+		}
+
+		CODEC_TRACE("%s: mapped %zu bytes", __FUNCTION__, mapped);
+		return new (p) detail::arena_block{nullptr, mapped - sizeof(detail::arena_block), mapped, pooled};
+	}
+
+	std::size_t          m_block_size;
+	pages                m_backing;
+	detail::arena_block* m_head {nullptr};
+	detail::arena_block* m_curr {nullptr};
+	uint8_t*             m_begin {nullptr};
+	uint8_t*             m_end {nullptr};
+};
+
+} //end: namespace med
@@ -34,20 +34,20 @@ constexpr T signextend(T x)
 	return x;
 }
 
-template <class DEC_CTX>
-struct decoder : info
+template <class DEC_CTX, class ERR_POLICY = default_error_policy>
+struct decoder : info, error_handler<decoder<DEC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	//required for length_encoder
 	using state_type = typename DEC_CTX::buffer_type::state_type;
 	using size_state = typename DEC_CTX::buffer_type::size_state;
 	using allocator_type = typename DEC_CTX::allocator_type;
 
-	explicit decoder(DEC_CTX& ctx_) : m_ctx{ ctx_ } { }
+	explicit decoder(DEC_CTX& ctx_, ERR_POLICY = {}) : m_ctx{ ctx_ } { }
 	DEC_CTX& get_context() noexcept             { return m_ctx; }
 	allocator_type& get_allocator()             { return get_context().get_allocator(); }
 
 	//state
-	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit); }
+	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit, *this); }
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)     { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                 { get_context().buffer().pop_state(); }
@@ -59,7 +59,8 @@ struct decoder : info
 	template <class IE> [[nodiscard]] std::size_t operator() (IE&, IE_TAG)
 	{
 		constexpr std::size_t NUM_BYTES = bits_to_bytes(IE::traits::bits);
-		uint8_t const* input = get_context().buffer().template advance<IE, NUM_BYTES>();
+		uint8_t const* input = get_context().buffer().template advance<IE, NUM_BYTES>(*this);
+		if (!input) { return 0; }
 		std::size_t const vtag = get_bytes<NUM_BYTES>(input);
 		CODEC_TRACE("T=%zX [%s] %zu bits: %s", vtag, name<IE>(), IE::traits::bits, get_context().buffer().toString());
 		return vtag;
@@ -87,6 +88,7 @@ struct decoder : info
 			while (this->operator()(CHECK_STATE{}, ie))
 			{
 				auto* field = ie.push_back(*this);
+				if (!field) { return; }
 				decode(*this, *field);
 			}
 			check_arity(*this, ie);
@@ -97,6 +99,7 @@ struct decoder : info
 			while (this->operator()(CHECK_STATE{}, ie))
 			{
 				auto* field = ie.push_back(*this);
+				if (!field) { return; }
 				this->operator()(*field, IE_VALUE{});
 			}
 			check_arity(*this, ie);
@@ -107,26 +110,29 @@ struct decoder : info
 			if constexpr (std::is_same_v<bool, typename IE::value_type>)
 			{
 				//X.690 8.2 Encoding of a boolean value
-				return ie.set_encoded(get_context().buffer().template pop<IE>() != 0);
+				return ie.set_encoded(get_context().buffer().template pop<IE>(*this) != 0);
 			}
 			else if constexpr (std::is_integral_v<typename IE::value_type>)
 			{
 				//X.690 8.3 Encoding of an integer value
 				//X.690 8.4 Encoding of an enumerated value
-				if (auto const len = get_context().buffer().size(); 0 < len && len < 127) //1..127 in one octet
+				using value_type = typename IE::value_type;
+				if (auto const len = get_context().buffer().size(); 0 < len && len <= sizeof(value_type))
 				{
 					CODEC_TRACE("\t%zu octets: %s", len, get_context().buffer().toString());
-					auto* input = get_context().buffer().template advance<IE>(len); //value
-					ie.set_encoded(read_bytes<typename IE::value_type>(input, len));
+					auto const* input = view<IE>(len);
+					if (!input) { return; }
+					get_context().buffer().template advance<IE>(len, *this); //value
+					ie.set_encoded(read_bytes<value_type>(input, len));
 				}
 				else
 				{
-					MED_THROW_EXCEPTION(invalid_value, name<IE>(), len, get_context().buffer())
+					MED_RETURN_ERROR(*this, invalid_value, name<IE>(), len, get_context().buffer())
 				}
 			}
 			else if constexpr (std::is_floating_point_v<typename IE::value_type>)
 			{
-				MED_THROW_EXCEPTION(unknown_tag, name<IE>(), 0, get_context().buffer())
+				MED_RETURN_ERROR(*this, unknown_tag, name<IE>(), 0, get_context().buffer())
 			}
 			else
 			{
@@ -138,17 +144,19 @@ struct decoder : info
 	//IE_BIT_STRING
 	template <class IE> void operator() (IE& ie, IE_BIT_STRING)
 	{
-		auto const unused_bits = get_context().buffer().template pop<IE>(); //num of unused bits [0..7]
+		auto const unused_bits = get_context().buffer().template pop<IE>(*this); //num of unused bits [0..7]
 		auto const len = get_context().buffer().size();
 		std::size_t const num_bits = len * 8 - unused_bits;
 		CODEC_TRACE("\tBSTR[%s] %zu bits: %s", name<IE>(), num_bits, get_context().buffer().toString());
-		if (ie.set_encoded(num_bits, get_context().buffer().begin()))
+		auto const* data = view<IE>(len);
+		if (len && !data) { return; }
+		if (ie.set_encoded(num_bits, data))
 		{
-			get_context().buffer().template advance<IE>(len);
+			get_context().buffer().template advance<IE>(len, *this);
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(invalid_value, name<IE>(), num_bits, get_context().buffer())
+			MED_RETURN_ERROR(*this, invalid_value, name<IE>(), num_bits, get_context().buffer())
 		}
 	}
 
@@ -157,13 +165,15 @@ struct decoder : info
 	{
 		auto const len = get_context().buffer().size();
 		CODEC_TRACE("\tOSTR[%s] %zu octets: %s", name<IE>(), len, get_context().buffer().toString());
-		if (ie.set_encoded(len, get_context().buffer().begin()))
+		auto const* data = view<IE>(len);
+		if (len && !data) { return; }
+		if (ie.set_encoded(len, data))
 		{
-			get_context().buffer().template advance<IE>(len);
+			get_context().buffer().template advance<IE>(len, *this);
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(invalid_value, name<IE>(), len, get_context().buffer())
+			MED_RETURN_ERROR(*this, invalid_value, name<IE>(), len, get_context().buffer())
 		}
 	}
 
@@ -171,24 +181,43 @@ struct decoder : info
 private:
 #endif
 
+	//contiguous octets at current position (stitched if input is segmented)
+	template <class IE>
+	uint8_t const* view(std::size_t len)
+	{
+		auto& buf = get_context().buffer();
+		if constexpr (requires { buf.template view<IE>(0, *this); }) //non-contiguous input
+		{
+			return buf.template view<IE>(len, *this);
+		}
+		else
+		{
+			if (len <= buf.size()) { return buf.begin(); }
+			this->template on_error<overflow>(name<IE>(), len, buf);
+			return nullptr;
+		}
+	}
+
 	template <class IE>
 	std::size_t ber_length()
 	{
-		uint8_t bytes = get_context().buffer().template pop<IE>();
+		uint8_t bytes = get_context().buffer().template pop<IE>(*this);
 		//short form
 		if (bytes < 0x80) { return bytes; }
 
 		bytes &= 0x7F;
-		if (bytes)
+		if (bytes && bytes <= sizeof(std::size_t))
 		{
-			return read_bytes<std::size_t>(get_context().buffer().template advance<IE>(bytes), bytes);
+			auto const* input = view<IE>(bytes);
+			if (!input) { return 0; }
+			get_context().buffer().template advance<IE>(bytes, *this);
+			return read_bytes<std::size_t>(input, bytes);
 		}
-		else //indefinite form (X.690 8.1.3.6)
+		//indefinite form (X.690 8.1.3.6)
 		//8.1.3.6 length octets indicate that the contents octets are terminated by end-of-contents octets
 		//(two zero octets), and shall consist of a single octet.
-		{
-			MED_THROW_EXCEPTION(invalid_value, name<IE>(), 0x80, get_context().buffer())
-		}
+		this->template on_error<invalid_value>(name<IE>(), 0x80 | bytes, get_context().buffer());
+		return 0;
 	}
 
 	template <typename T>
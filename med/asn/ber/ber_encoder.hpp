@@ -19,14 +19,14 @@ Distributed under the MIT License
 
 namespace med::asn::ber {
 
-template <class ENC_CTX>
-struct encoder : info
+template <class ENC_CTX, class ERR_POLICY = default_error_policy>
+struct encoder : info, error_handler<encoder<ENC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	//required for length_encoder
 	using state_type = typename ENC_CTX::buffer_type::state_type;
 	using allocator_type = typename ENC_CTX::allocator_type;
 
-	explicit encoder(ENC_CTX& ctx_) : m_ctx{ ctx_ } { }
+	explicit encoder(ENC_CTX& ctx_, ERR_POLICY = {}) : m_ctx{ ctx_ } { }
 	ENC_CTX& get_context() noexcept                   { return m_ctx; }
 	allocator_type& get_allocator()                   { return get_context().get_allocator(); }
 
@@ -45,20 +45,26 @@ struct encoder : info
 			}
 			else
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<IE>(), len, get_context().buffer())
+				MED_RETURN_ERROR(*this, invalid_value, name<IE>(), len, get_context().buffer())
 			}
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0, get_context().buffer())
+			MED_RETURN_ERROR(*this, missing_ie, name<IE>(), 1, 0, get_context().buffer())
 		}
 	}
 
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)             { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                         { get_context().buffer().pop_state(); }
-	void operator() (ADVANCE_STATE ss)                  { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta); }
-	void operator() (SNAPSHOT ss)                       { get_context().put_snapshot(ss); }
+	void operator() (ADVANCE_STATE ss)                  { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta, *this); }
+	void operator() (SNAPSHOT ss)
+	{
+		if (not get_context().put_snapshot(ss))
+		{
+			MED_RETURN_ERROR(*this, out_of_memory, ss.id, ss.size, get_context().buffer())
+		}
+	}
 
 	//calculate length of IE (can be either a data itself or TAG/LEN already extracted from META-INFO
 	template <class IE>
@@ -116,7 +122,8 @@ struct encoder : info
 				}
 				else if constexpr (std::is_floating_point_v<value_type>)
 				{
-					MED_THROW_EXCEPTION(unknown_tag, name<IE>(), 0, get_context().buffer())
+					this->template on_error<unknown_tag>(name<IE>(), 0, get_context().buffer());
+					return 0;
 				}
 				else
 				{
@@ -147,7 +154,8 @@ struct encoder : info
 	template <class IE> void operator() (IE const& ie, IE_TAG)
 	{
 		constexpr std::size_t nbytes = bits_to_bytes(IE::traits::bits);
-		uint8_t* out = get_context().buffer().template advance<IE, nbytes>();
+		uint8_t* out = get_context().buffer().template advance<IE, nbytes>(*this);
+		if (!out) { return; }
 		CODEC_TRACE("tag[%s]=%zXh %zu bytes: %s", name<IE>(), std::size_t(ie.get()), nbytes, get_context().buffer().toString());
 		put_bytes<nbytes>(ie.get(), out);
 	}
@@ -187,12 +195,13 @@ struct encoder : info
 				{
 					auto const encoded = detail::encode_unsigned(field.get());
 					auto const len = detail::least_bytes_encoded(field.get());
-					uint8_t* out = get_context().buffer().template advance<IE>(len); //value
+					uint8_t* out = get_context().buffer().template advance<IE>(len, *this); //value
+					if (!out) { return; }
 					write_bytes(encoded, out, len); //value
 				}
 				else
 				{
-					MED_THROW_EXCEPTION(missing_ie, name<IE>(), ie.count(), ie.count() - 1)
+					MED_RETURN_ERROR(*this, missing_ie, name<IE>(), ie.count(), ie.count() - 1)
 				}
 			}
 		}
@@ -202,7 +211,7 @@ struct encoder : info
 			if constexpr (std::is_same_v<bool, value_type>)
 			{
 				//X.690 8.2 Encoding of a boolean value
-				get_context().buffer().template push<IE>(ie.get_encoded() ? 0xFF : 0x00);
+				get_context().buffer().template push<IE>(ie.get_encoded() ? 0xFF : 0x00, *this);
 				CODEC_TRACE("BOOL[%s]=%zXh: %s", name<IE>(), std::size_t(ie.get_encoded()), get_context().buffer().toString());
 			}
 			else if constexpr (std::is_integral_v<value_type>)
@@ -210,7 +219,8 @@ struct encoder : info
 				//X.690 8.3 Encoding of an integer value
 				//X.690 8.4 Encoding of an enumerated value
 				auto const len = length::bytes<value_type>(ie.get_encoded());
-				uint8_t* out = get_context().buffer().template advance<IE>(len); //value
+				uint8_t* out = get_context().buffer().template advance<IE>(len, *this); //value
+				if (!out) { return; }
 				//*out++ = len; //length in 1 byte, no sense in more than 9 (17 in future?) bytes for integer
 				write_bytes(ie.get_encoded(), out, len); //value
 				CODEC_TRACE("INT[%s]=%lld %u bytes: %s", name<IE>(), (long long)ie.get_encoded(), len, get_context().buffer().toString());
@@ -218,7 +228,7 @@ struct encoder : info
 			else if constexpr (std::is_floating_point_v<value_type>)
 			{
 				//TODO: implement
-				MED_THROW_EXCEPTION(unknown_tag, name<IE>(), 0, get_context().buffer())
+				MED_RETURN_ERROR(*this, unknown_tag, name<IE>(), 0, get_context().buffer())
 			}
 			else
 			{
@@ -235,8 +245,9 @@ struct encoder : info
 		// the number of unused bits in the final subsequent octet in the range [0..7].
 		//8.6.2.3 If the bitstring is empty, there shall be no subsequent octets, and the initial
 		// octet shall be zero.
-		get_context().buffer().template push<IE>( uint8_t(8 - uint8_t(ie.get().least_bits())) );
-		auto* out = get_context().buffer().template advance<IE>(ie.size());
+		get_context().buffer().template push<IE>(uint8_t(8 - uint8_t(ie.get().least_bits())), *this);
+		auto* out = get_context().buffer().template advance<IE>(ie.size(), *this);
+		if (!out) { return; }
 		octets<IE::traits::min_bits/8, IE::traits::max_bits/8>::copy(out, ie.data(), ie.size());
 		CODEC_TRACE("STR[%s] %zu bits: %s", name<IE>(), std::size_t(ie.get().num_of_bits()), get_context().buffer().toString());
 	}
@@ -245,7 +256,8 @@ struct encoder : info
 	template <class IE> void operator() (IE const& ie, IE_OCTET_STRING)
 	{
 		//X.690 8.7 Encoding of an octetstring value (not segmented only)
-		auto* out = get_context().buffer().template advance<IE>(ie.size());
+		auto* out = get_context().buffer().template advance<IE>(ie.size(), *this);
+		if (!out) { return; }
 		octets<IE::traits::min_octets, IE::traits::max_octets>::copy(out, ie.data(), ie.size());
 		CODEC_TRACE("STR[%s] %zu octets: %s", name<IE>(), ie.size(), get_context().buffer().toString());
 	}
@@ -262,7 +274,7 @@ private:
 		if (len < 0x80)
 		{
 			// 8.1.3.4 short form can only be used when length <= 127.
-			get_context().buffer().template push<IE>(len);
+			get_context().buffer().template push<IE>(len, *this);
 		}
 		else
 		{
@@ -272,7 +284,8 @@ private:
 			// c) the value 0b11111111 shall not be used.
 			// Subsequent octets encode as unsigned binary integer equal to the the length value.
 			uint8_t const bytes = length::bytes(len);
-			uint8_t* out = get_context().buffer().template advance<IE>(1 + bytes);
+			uint8_t* out = get_context().buffer().template advance<IE>(1 + bytes, *this);
+			if (!out) { return; }
 			*out++ = bytes | 0x80;
 			write_bytes(len, out, bytes);
 		}
@@ -8,7 +8,8 @@
 
 namespace med::asn::ber {
 
-struct info
+template <class LEN_VALUE>
+struct basic_info
 {
 private:
 	template <class T, class CONSTRUCTED = std::true_type>
@@ -66,12 +67,14 @@ b) the contents octets shall be the same as the contents octets of the base enco
 				}
 			};
 
-			//!TODO: LENSIZE need to calc len to known its size (only 1 byte for now)
-			using len_t = add_len<value<uint8_t>>;
+			using len_t = add_len<LEN_VALUE>;
 			using meta_info = meta::interleave_t< meta::unwrap_t<decltype(get_tags())>, len_t>;
 			return meta::wrap<meta_info>{};
 		}
 	}
 };
 
+//!TODO: LENSIZE need to calc len to known its size (only 1 byte for now)
+using info = basic_info<value<uint8_t>>;
+
 } //end: namespace med::asn::ber
@@ -0,0 +1,225 @@
+#pragma once
+/**
+@file
+ASN.1 BER back-to-front encoder definition
+
+@copyright Denis Priyomov 2018
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+#include <span>
+
+#include "debug.hpp"
+#include "name.hpp"
+#include "state.hpp"
+#include "octet_string.hpp"
+#include "ber_tag.hpp"
+#include "ber_length.hpp"
+#include "ber_info.hpp"
+#include "../asn.hpp"
+
+
+namespace med::asn::ber {
+
+/**
+ * BER encoder writing from the end of buffer towards its start
+ * @details The contents of IE are encoded first then its definite length
+ * and tag thus the length is known w/o calculating it in advance and any
+ * IE is visited only once regardless of the nesting.
+ * The encoded octets end at the end of buffer and are accessed via encoded().
+ * NOTE: the end of context's buffer is moved to the 1st encoded octet thus
+ * the context needs to be reset with whole buffer to encode again.
+ */
+template <class ENC_CTX, class ERR_POLICY = default_error_policy>
+struct reverse_encoder : basic_info<value<uint32_t>>, error_handler<reverse_encoder<ENC_CTX, ERR_POLICY>, ERR_POLICY>
+{
+	using state_type = typename ENC_CTX::buffer_type::state_type;
+	using allocator_type = typename ENC_CTX::allocator_type;
+	static constexpr bool back_to_front = true;
+
+	explicit reverse_encoder(ENC_CTX& ctx_, ERR_POLICY = {})
+		: m_ctx{ ctx_ }, m_tail{ ctx_.buffer().end() } { }
+	ENC_CTX& get_context() noexcept                   { return m_ctx; }
+	allocator_type& get_allocator()                   { return get_context().get_allocator(); }
+
+	//octets encoded so far
+	std::span<uint8_t const> encoded() const noexcept
+	{
+		uint8_t const* head = m_ctx.buffer().end();
+		return {head, std::size_t(m_tail - head)};
+	}
+
+	//state is the position of the 1st encoded octet
+	state_type operator() (GET_STATE)
+	{
+		state_type st;
+		st.reset(get_context().buffer().end());
+		return st;
+	}
+
+	//IE_TAG
+	template <class IE> void operator() (IE const& ie, IE_TAG)
+	{
+		constexpr std::size_t nbytes = bits_to_bytes(IE::traits::bits);
+		uint8_t* out = prepend<IE>(nbytes);
+		if (!out) { return; }
+		put_bytes<nbytes>(ie.get(), out);
+		CODEC_TRACE("tag[%s]=%zXh %zu bytes: %s", name<IE>(), std::size_t(ie.get()), nbytes, get_context().buffer().toString());
+	}
+
+	//IE_LEN
+	template <class IE> void operator() (IE const& ie, IE_LEN)
+	{
+		CODEC_TRACE("len[%s]=%zXh: %s", name<IE>(), std::size_t(ie.get()), get_context().buffer().toString());
+		ber_length<IE>(ie.get());
+	}
+
+	//IE_NULL
+	template <class IE> constexpr void operator() (IE const&, IE_NULL) const
+	{
+		//X.690 8.8 Encoding of a null value
+		//8.8.2 The contents octets shall not contain any octets.
+	}
+
+	//IE_VALUE
+	template <class IE> void operator() (IE const& ie, IE_VALUE)
+	{
+		if constexpr (is_seqof_v<IE>)
+		{
+			CODEC_TRACE("SEQOF[%s] *%zu", name<IE>(), ie.count());
+			sl::encode_multi(*this, ie);
+		}
+		else if constexpr (is_oid_v<IE>)
+		{
+			CODEC_TRACE("OID[%s] *%zu", name<IE>(), ie.count());
+			sl::foreach_field(*this, ie, [this, &ie](auto const& field)
+			{
+				if (field.is_set())
+				{
+					auto const len = detail::least_bytes_encoded(field.get());
+					uint8_t* out = prepend<IE>(len);
+					if (!out) { return; }
+					write_bytes(detail::encode_unsigned(field.get()), out, len);
+				}
+				else
+				{
+					MED_RETURN_ERROR(*this, missing_ie, name<IE>(), ie.count(), ie.count() - 1)
+				}
+			});
+		}
+		else
+		{
+			using value_type = typename IE::value_type;
+			if constexpr (std::is_same_v<bool, value_type>)
+			{
+				//X.690 8.2 Encoding of a boolean value
+				uint8_t* out = prepend<IE>(1);
+				if (!out) { return; }
+				*out = ie.get_encoded() ? 0xFF : 0x00;
+				CODEC_TRACE("BOOL[%s]=%zXh: %s", name<IE>(), std::size_t(ie.get_encoded()), get_context().buffer().toString());
+			}
+			else if constexpr (std::is_integral_v<value_type>)
+			{
+				//X.690 8.3 Encoding of an integer value
+				//X.690 8.4 Encoding of an enumerated value
+				auto const len = length::bytes<value_type>(ie.get_encoded());
+				uint8_t* out = prepend<IE>(len);
+				if (!out) { return; }
+				write_bytes(ie.get_encoded(), out, len);
+				CODEC_TRACE("INT[%s]=%lld %u bytes: %s", name<IE>(), (long long)ie.get_encoded(), len, get_context().buffer().toString());
+			}
+			else if constexpr (std::is_floating_point_v<value_type>)
+			{
+				//TODO: implement
+				MED_RETURN_ERROR(*this, unknown_tag, name<IE>(), 0, get_context().buffer())
+			}
+			else
+			{
+				static_assert(std::is_void_v<value_type>, "NOT IMPLEMENTED?");
+			}
+		}
+	}
+
+	//IE_BIT_STRING
+	template <class IE> void operator() (IE const& ie, IE_BIT_STRING)
+	{
+		//X.690 8.6 Encoding of a bitstring value (not segmented only)
+		//initial octet of unused bits followed by the bits
+		uint8_t* out = prepend<IE>(1 + ie.size());
+		if (!out) { return; }
+		*out++ = uint8_t(8 - uint8_t(ie.get().least_bits()));
+		octets<IE::traits::min_bits/8, IE::traits::max_bits/8>::copy(out, ie.data(), ie.size());
+		CODEC_TRACE("STR[%s] %zu bits: %s", name<IE>(), std::size_t(ie.get().num_of_bits()), get_context().buffer().toString());
+	}
+
+	//IE_OCTET_STRING
+	template <class IE> void operator() (IE const& ie, IE_OCTET_STRING)
+	{
+		//X.690 8.7 Encoding of an octetstring value (not segmented only)
+		uint8_t* out = prepend<IE>(ie.size());
+		if (!out) { return; }
+		octets<IE::traits::min_octets, IE::traits::max_octets>::copy(out, ie.data(), ie.size());
+		CODEC_TRACE("STR[%s] %zu octets: %s", name<IE>(), ie.size(), get_context().buffer().toString());
+	}
+
+#ifndef UNIT_TEST
+private:
+#endif
+	//reserves the octets in front of already encoded ones
+	template <class IE>
+	uint8_t* prepend(std::size_t count)
+	{
+		auto& buf = get_context().buffer();
+		if (buf.size() < count)
+		{
+			this->template on_error<overflow>(name<IE>(), count, buf);
+			return nullptr;
+		}
+		buf.end(buf.end() - count);
+		return buf.end();
+	}
+
+	template <class IE>
+	void ber_length(std::size_t len)
+	{
+		// X.690 8.1.3.3 in definite form length octets consist of 1+ octets,
+		// in short (8.1.3.4) or long form (8.1.3.5).
+		if (len < 0x80)
+		{
+			uint8_t* out = prepend<IE>(1);
+			if (!out) { return; }
+			*out = uint8_t(len);
+		}
+		else
+		{
+			//initial octet of subsequent octets number followed by the length
+			uint8_t const bytes = length::bytes(len);
+			uint8_t* out = prepend<IE>(1 + bytes);
+			if (!out) { return; }
+			*out++ = bytes | 0x80;
+			write_bytes(len, out, bytes);
+		}
+	}
+
+	template <typename T>
+	void write_bytes(T const value, uint8_t* output, uint8_t num_bytes)
+	{
+		switch (num_bytes)
+		{
+		case 1: put_bytes<1>(value, output); break;
+		case 2: if constexpr (sizeof(T) >= 2) { put_bytes<2>(value, output); break; }
+		case 3: if constexpr (sizeof(T) >= 3) { put_bytes<3>(value, output); break; }
+		case 4: if constexpr (sizeof(T) >= 4) { put_bytes<4>(value, output); break; }
+		case 5: if constexpr (sizeof(T) >= 5) { put_bytes<5>(value, output); break; }
+		case 6: if constexpr (sizeof(T) >= 6) { put_bytes<6>(value, output); break; }
+		case 7: if constexpr (sizeof(T) >= 7) { put_bytes<7>(value, output); break; }
+		case 8: if constexpr (sizeof(T) >= 8) { put_bytes<8>(value, output); break; }
+		default: MED_RETURN_ERROR(*this, invalid_value, __FUNCTION__, num_bytes)
+		}
+	}
+
+	ENC_CTX& m_ctx;
+	uint8_t const* m_tail;
+};
+
+}	//end: namespace med::asn::ber
@@ -0,0 +1,133 @@
+/**
+@file
+decoding of back-to-back framed messages
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <span>
+
+#include "bytes.hpp"
+#include "decode.hpp"
+#include "exception.hpp"
+#include "length.hpp"
+
+namespace med {
+
+/**
+ * Framing by length field in the message header
+ * @details The length is of the octets following the length field itself (same
+ * as med length) thus the frame is OFFSET + sizeof(length) + length octets.
+ * Custom get_length() of LEN_IE is used if present.
+ * @tparam OFFSET offset of the length field in the frame
+ * @tparam LEN_IE the length field (byte-aligned value)
+ */
+template <std::size_t OFFSET, class LEN_IE>
+struct length_framing
+{
+	using traits = typename LEN_IE::traits;
+	static_assert(traits::offset == 0 && (traits::bits % 8) == 0, "BYTE-ALIGNED LENGTH EXPECTED");
+	static constexpr std::size_t header_size = OFFSET + bits_to_bytes(traits::bits);
+
+	//@return size of the frame or 0 if not enough data to tell
+	static constexpr std::size_t frame_size(uint8_t const* data, std::size_t size) noexcept
+	{
+		if (size < header_size) { return 0; }
+		LEN_IE ie;
+		ie.set_encoded(get_bytes<header_size - OFFSET, typename LEN_IE::value_type>(data + OFFSET));
+		return header_size + value_to_length(ie);
+	}
+};
+
+namespace detail {
+
+template <class FRAMING, class DECODER, class GET_IE, class ON_DONE>
+std::size_t decode_frames(DECODER& decoder, std::span<uint8_t const> input, GET_IE get_ie, ON_DONE on_done)
+{
+	static_assert(requires { decoder.failed(); }, "DECODER WITH STATUS ERROR POLICY EXPECTED");
+
+	auto& ctx = decoder.get_context();
+	uint8_t const* frame = input.data();
+	std::size_t left = input.size();
+	std::size_t frame_size = FRAMING::frame_size(frame, left);
+
+	for (std::size_t index = 0; frame_size && frame_size <= left; ++index)
+	{
+		auto* ie = get_ie(index);
+		if (!ie) { break; }
+
+		uint8_t const* const next = frame + frame_size;
+		std::size_t const next_left = left - frame_size;
+#ifdef __GNUC__
+		__builtin_prefetch(next);
+#endif
+		ctx.reset(frame, frame_size);
+		decoder.reset_status();
+		med::decode(decoder, *ie);
+		on_done(*ie, decoder.status());
+
+		frame = next;
+		left = next_left;
+		frame_size = FRAMING::frame_size(frame, left);
+	}
+	return input.size() - left;
+}
+
+}	//end: namespace detail
+
+/**
+ * Decodes each complete frame of the input into the same message
+ * @details Errors are reported per message and don't stop the batch.
+ * The context allocator (if it can be released) is released before each
+ * frame as the message decoded from previous one is dropped.
+ * @param decoder decoder with status error policy (its context is reused)
+ * @param input back-to-back frames
+ * @param ie message to decode into (cleared before each frame)
+ * @param func called with the message and its status after each frame
+ * @return number of octets consumed (the incomplete tail is left)
+ */
+template <class FRAMING, class DECODER, AHasIeType IE, class FUNC>
+std::size_t decode_batch(DECODER&& decoder, std::span<uint8_t const> input, IE& ie, FUNC&& func)
+{
+	return detail::decode_frames<FRAMING>(decoder, input
+		, [&ie, &decoder](std::size_t)
+		{
+			ie.clear();
+			auto& ctx = decoder.get_context();
+			if constexpr (requires { ctx.get_allocator().release(); }) { ctx.get_allocator().release(); }
+			return &ie;
+		}
+		, [&func](IE& msg, med::status const& st) { func(msg, st); });
+}
+
+/**
+ * Decodes each complete frame of the input into the array of messages
+ * @details The context allocator is shared by all the messages decoded
+ * thus it's up to caller to release it when they're no longer used.
+ * @param decoder decoder with status error policy (its context is reused)
+ * @param input back-to-back frames
+ * @param out messages to decode into (each is cleared before its frame)
+ * @param res statuses of the decoded messages (optional)
+ * @return number of decoded messages
+ */
+template <class FRAMING, class DECODER, AHasIeType IE>
+std::size_t decode_batch(DECODER&& decoder, std::span<uint8_t const> input, std::span<IE> out
+	, std::span<med::status> res = {})
+{
+	std::size_t count = 0;
+	detail::decode_frames<FRAMING>(decoder, input
+		, [&out](std::size_t index) -> IE*
+		{
+			if (index >= out.size()) { return nullptr; }
+			out[index].clear();
+			return &out[index];
+		}
+		, [&res, &count](IE&, med::status const& st) { if (count < res.size()) { res[count] = st; } ++count; });
+	return count;
+}
+
+}	//end: namespace med
@@ -40,7 +40,7 @@ public:
 
 	std::size_t uint() const
 	{
-		if (not inplace()) { throw invalid_value("too many bits", std::size_t(num_of_bits())); }
+		if (not inplace()) { MED_THROW_EXCEPTION(invalid_value, "too many bits", std::size_t(num_of_bits())) }
 		std::size_t v = m_data.internal[0];
 		for (std::size_t n = 1; n < size(); ++n) { v = (v << 8) | m_data.internal[n]; }
 		return v >> (8 - m_least_bits);
@@ -69,7 +69,7 @@ private:
 	void set_nums(nbits num_bits)
 	{
 		auto const num_bytes = bits_to_bytes(std::size_t(num_bits));
-		if (num_bytes > MAX) { throw invalid_value("number of bits", std::size_t(num_bits)); }
+		if (num_bytes > MAX) { MED_THROW_EXCEPTION(invalid_value, "number of bits", std::size_t(num_bits)) }
 
 		m_num_bytes = static_cast<decltype(m_num_bytes)>(num_bytes);
 		m_least_bits = calc_least_bits(std::size_t(num_bits));
@@ -21,11 +21,67 @@ Distributed under the MIT License
 
 namespace med {
 
+namespace detail {
+
+//changes the size (end) of the buffer memorizing current end to rollback in dtor
+template <class BUFFER>
+class buffer_size_state
+{
+	using eob_index_t = uint8_t;
+	static constexpr eob_index_t MAX_EOB_INDEX = std::numeric_limits<eob_index_t>::max();
+
+public:
+	constexpr buffer_size_state() noexcept = default;
+	buffer_size_state(buffer_size_state const&) = delete;
+	buffer_size_state& operator= (buffer_size_state const&) = delete;
+
+	constexpr buffer_size_state(buffer_size_state&& rhs) noexcept
+		: m_buffer{ rhs.m_buffer }
+		, m_index{ rhs.m_index }
+		, m_commited{ rhs.m_commited }
+	{
+		rhs.clear();
+	}
+
+	constexpr buffer_size_state& operator= (buffer_size_state&& rhs) noexcept
+	{
+		m_buffer = rhs.m_buffer;
+		m_index = rhs.m_index;
+		m_commited = rhs.m_commited;
+		rhs.clear();
+		return *this;
+	}
+
+	~buffer_size_state()                              { restore_end(); }
+
+	constexpr void restore_end()                      { if (m_buffer) m_buffer->restore_end(*this); }
+	constexpr void commit(int delta)                  { m_buffer->commit_end(*this, delta); }
+
+	constexpr std::size_t size() const noexcept       { return m_buffer ? m_buffer->size() : 0; }
+	explicit constexpr operator bool() const noexcept { return !empty(); }
+
+private:
+	friend BUFFER;
+	constexpr buffer_size_state(BUFFER* buf, eob_index_t idx, bool commit_)
+		: m_buffer{ buf }
+		, m_index{ idx }
+		, m_commited{ commit_ }
+	{}
+
+	constexpr bool empty() const noexcept             { return m_index == MAX_EOB_INDEX; }
+	constexpr void clear() noexcept                   { m_index = MAX_EOB_INDEX; }
+
+	BUFFER*     m_buffer{ nullptr };
+	eob_index_t m_index{ MAX_EOB_INDEX };
+	bool        m_commited{ false };
+};
+
+}	//end: namespace detail
+
 template <typename T, std::size_t LEN_DEPTH = 16> requires (sizeof(T) == 1 && std::is_integral_v<T>)
 class buffer
 {
 	using eob_index_t = uint8_t;
-	static constexpr eob_index_t MAX_EOB_INDEX = std::numeric_limits<eob_index_t>::max();
 
 public:
 	using pointer = T*;
@@ -54,56 +110,9 @@ public:
 	};
 
 
-	//changes the size (end) of the buffer memorizing current end to rollback in dtor
-	class size_state
-	{
-	public:
-		constexpr size_state() noexcept = default;
-		size_state(size_state const&) = delete;
-		size_state& operator= (size_state const&) = delete;
-
-		constexpr size_state(size_state&& rhs) noexcept
-			: m_buffer{ rhs.m_buffer }
-			, m_index{ rhs.m_index }
-			, m_commited{ rhs.m_commited }
-		{
-			rhs.clear();
-		}
-
-		constexpr size_state& operator= (size_state&& rhs) noexcept
-		{
-			m_buffer = rhs.m_buffer;
-			m_index = rhs.m_index;
-			m_commited = rhs.m_commited;
-			rhs.clear();
-			return *this;
-		}
-
-		~size_state()                                     { restore_end(); }
-
-		constexpr void restore_end()                      { if (m_buffer) m_buffer->restore_end(*this); }
-		constexpr void commit(int delta)                  { m_buffer->commit_end(*this, delta); }
-
-		constexpr std::size_t size() const noexcept       { return m_buffer ? m_buffer->size() : 0; }
-		explicit constexpr operator bool() const noexcept { return !empty(); }
-
-	private:
-		friend class buffer;
-		constexpr size_state(buffer* buf, eob_index_t idx, bool commit_)
-			: m_buffer{ buf }
-			, m_index{ idx }
-			, m_commited{ commit_ }
-		{}
-
-		constexpr bool empty() const noexcept             { return m_index == MAX_EOB_INDEX; }
-		constexpr void clear() noexcept                   { m_index = MAX_EOB_INDEX; }
-
-		buffer*     m_buffer{ nullptr };
-		eob_index_t m_index{ MAX_EOB_INDEX };
-		bool        m_commited{ false };
-	};
+	using size_state = detail::buffer_size_state<buffer>;
 
-	constexpr auto push_size(std::size_t size, bool commit_)
+	constexpr auto push_size(std::size_t size, bool commit_, auto&& err)
 	{
 		if (auto* pend = begin() + size; pend <= end()) //within the current end of buffer
 		{
@@ -126,15 +135,18 @@ public:
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(overflow, "end of buffer", pend - end());
+			err.template on_error<overflow>("end of buffer", size, *this);
+			return size_state{};
 		}
 	}
+	constexpr auto push_size(std::size_t size, bool commit_)    { return push_size(size, commit_, throw_on_error{}); }
 
-	constexpr void reset() noexcept                  { m_state.reset(get_start()); }
+	constexpr void reset() noexcept                  { m_state.reset(get_start()); m_eob_index = 0; }
 	constexpr void reset(void const* p, std::size_t s) noexcept
 	{
 		m_start = static_cast<pointer>(const_cast<void*>(p));
 		m_state.reset(m_start);
+		m_eob_index = 0;
 		end(m_start + s);
 	}
 	template <typename U> requires (std::is_integral_v<U>)
@@ -174,38 +186,58 @@ public:
 	constexpr std::span<value_type> used() const noexcept   { return {get_start(), get_offset()}; }
 	constexpr size_t size() const noexcept                  { return end() - begin(); }
 	constexpr bool empty() const noexcept                   { return begin() >= end(); }
+	//number of nested size scopes (lengths) currently applied
+	constexpr std::size_t depth() const noexcept            { return m_eob_index; }
 	explicit constexpr operator bool() const noexcept       { return !empty(); }
 
-	template <class IE> constexpr void push(value_type v) requires (!is_const_v)
+	template <class IE> constexpr void push(value_type v, auto&& err) requires (!is_const_v)
 	{
 		if (not empty()) { *m_state.cursor++ = v; }
-		else { MED_THROW_EXCEPTION(overflow, name<IE>(), sizeof(value_type), *this) }
+		else { err.template on_error<overflow>(name<IE>(), sizeof(value_type), *this); }
 	}
+	template <class IE> constexpr void push(value_type v) requires (!is_const_v)
+		{ push<IE>(v, throw_on_error{}); }
 
-	template <class IE> constexpr value_type pop() requires (is_const_v)
+	template <class IE> constexpr value_type pop(auto&& err) requires (is_const_v)
 	{
 		if (not empty()) { return *m_state.cursor++; }
-		else { MED_THROW_EXCEPTION(overflow, name<IE>(), sizeof(value_type), *this) }
+		err.template on_error<overflow>(name<IE>(), sizeof(value_type), *this);
+		return {};
 	}
+	template <class IE> constexpr value_type pop() requires (is_const_v)
+		{ return pop<IE>(throw_on_error{}); }
 
 	//TODO: remove excessive dependencies (IE) to reduce code-bloat
-	template <class IE, size_t DELTA> constexpr pointer advance()
+	template <class IE, size_t DELTA> constexpr pointer advance(auto&& err)
 	{
-		if (size() < DELTA) { MED_THROW_EXCEPTION(overflow, name<IE>(), DELTA, *this) }
+		if (size() < DELTA)
+		{
+			err.template on_error<overflow>(name<IE>(), DELTA, *this);
+			return nullptr;
+		}
 		auto p = begin();
 		m_state.cursor += DELTA;
 		return p;
 	}
-	template <class IE, size_t BITS> constexpr pointer advance_bits()
+	template <class IE, size_t DELTA> constexpr pointer advance()
+		{ return advance<IE, DELTA>(throw_on_error{}); }
+
+	template <class IE, size_t BITS> constexpr pointer advance_bits(auto&& err)
 	{
 		constexpr auto NUM_BYTES = bits_to_bytes(BITS); //ceil to include traling byte if any
-		if (size() < NUM_BYTES) { MED_THROW_EXCEPTION(overflow, name<IE>(), NUM_BYTES, *this) }
+		if (size() < NUM_BYTES)
+		{
+			err.template on_error<overflow>(name<IE>(), NUM_BYTES, *this);
+			return nullptr;
+		}
 		auto p = begin();
 		m_state.cursor += BITS / 8; //floor to not include trailing byte
 		return p;
 	}
+	template <class IE, size_t BITS> constexpr pointer advance_bits()
+		{ return advance_bits<IE, BITS>(throw_on_error{}); }
 
-	template <class IE = void> constexpr pointer advance(int delta)
+	template <class IE = void> constexpr pointer advance(int delta, auto&& err)
 	{
 		pointer p = nullptr;
 		if (delta >= 0 && size() >= std::size_t(delta))
@@ -220,15 +252,17 @@ public:
 		}
 		else if constexpr (not std::is_void_v<IE>)
 		{
-			MED_THROW_EXCEPTION(overflow, name<IE>(), delta, *this)
+			err.template on_error<overflow>(name<IE>(), delta, *this);
 		}
 		return p;
 	}
+	template <class IE = void> constexpr pointer advance(int delta)
+		{ return advance<IE>(delta, throw_on_error{}); }
 
 	/// similar to advance but no bounds check
 	constexpr void offset(int delta) noexcept               { m_state.cursor += delta; }
 
-	template <class IE> constexpr void fill(std::size_t count, uint8_t value) requires (!is_const_v)
+	template <class IE> constexpr void fill(std::size_t count, uint8_t value, auto&& err) requires (!is_const_v)
 	{
 		//CODEC_TRACE("padding %zu bytes=%u", count, value);
 		if (size() >= count)
@@ -237,9 +271,25 @@ public:
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(overflow, name<IE>(), count, *this)
+			err.template on_error<overflow>(name<IE>(), count, *this);
 		}
 	}
+	template <class IE> constexpr void fill(std::size_t count, uint8_t value) requires (!is_const_v)
+		{ fill<IE>(count, value, throw_on_error{}); }
+
+	/**
+	 * Stops processing of the rest of buffer
+	 * @details Used after error reported w/o exception to fail all subsequent reads/writes
+	 */
+	constexpr void halt() noexcept
+	{
+		//move to the outermost end which is also restored at any depth
+		pointer last = end();
+		for (eob_index_t i = 0; i < m_eob_index; ++i) { last = std::max(last, m_eob[i]); }
+		for (eob_index_t i = 0; i < m_eob_index; ++i) { m_eob[i] = last; }
+		m_state.cursor = m_end = last;
+		m_store.reset();
+	}
 
 	constexpr pointer begin() const noexcept                { return m_state.cursor; }
 	constexpr pointer end() const noexcept                  { return m_end; }
@@ -270,7 +320,7 @@ public:
 	}
 
 private:
-	friend class size_state;
+	friend size_state;
 
 	constexpr void restore_end(size_state& ss)
 	{
@@ -316,4 +366,63 @@ private:
 	pointer        m_eob[LEN_DEPTH]{};
 };
 
+/**
+ * Buffer for encoding into the space reserved for exact encoded size
+ * @details Writes are not checked against the end of buffer thus the space
+ * has to be reserved for the size given by encoded_size.
+ */
+template <std::size_t LEN_DEPTH = 16>
+class unchecked_buffer : public buffer<uint8_t, LEN_DEPTH>
+{
+	using base_t = buffer<uint8_t, LEN_DEPTH>;
+
+public:
+	using typename base_t::pointer;
+	using typename base_t::value_type;
+
+	template <class IE> constexpr void push(value_type v, auto&&) noexcept
+	{
+		*take(1) = v;
+	}
+	template <class IE> constexpr void push(value_type v) noexcept      { push<IE>(v, nullptr); }
+
+	template <class IE, size_t DELTA> constexpr pointer advance(auto&&) noexcept
+		{ return take(DELTA); }
+	template <class IE, size_t DELTA> constexpr pointer advance() noexcept  { return advance<IE, DELTA>(nullptr); }
+
+	template <class IE, size_t BITS> constexpr pointer advance_bits(auto&&) noexcept
+	{
+		assume_fits(bits_to_bytes(BITS)); //ceil to include traling byte if any
+		return take(BITS / 8); //floor to not include trailing byte
+	}
+	template <class IE, size_t BITS> constexpr pointer advance_bits() noexcept { return advance_bits<IE, BITS>(nullptr); }
+
+	template <class IE = void> constexpr pointer advance(int delta, auto&&) noexcept
+	{
+		if (delta >= 0) { return take(std::size_t(delta)); }
+		this->offset(delta);
+		return this->begin();
+	}
+	template <class IE = void> constexpr pointer advance(int delta) noexcept { return advance<IE>(delta, nullptr); }
+
+	template <class IE> constexpr void fill(std::size_t count, uint8_t value, auto&&) noexcept
+		{ std::fill_n(take(count), count, value); }
+	template <class IE> constexpr void fill(std::size_t count, uint8_t value) noexcept { fill<IE>(count, value, nullptr); }
+
+private:
+	//the space is reserved thus the bounds are assumed rather than checked
+	constexpr void assume_fits(std::size_t num) const noexcept
+	{
+		if (this->size() < num) { __builtin_unreachable(); }
+	}
+
+	constexpr pointer take(std::size_t num) noexcept
+	{
+		assume_fits(num);
+		auto p = this->begin();
+		this->offset(int(num));
+		return p;
+	}
+};
+
 }	//end: namespace med
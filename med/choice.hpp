@@ -18,6 +18,8 @@ Distributed under the MIT License
 #include "value.hpp"
 #include "encode.hpp"
 #include "decode.hpp"
+#include "projection.hpp"
+#include "sl/ie_skip.hpp"
 #include "meta/unique.hpp"
 #include "meta/typelist.hpp"
 
@@ -106,6 +108,22 @@ struct choice_copy : choice_if
 	static constexpr void apply(FROM const&, TO&, ARGS&&...) { }
 };
 
+//constructs the selected case from the one of other choice of same type
+struct choice_construct : choice_if
+{
+	template <class IE, class FROM, class TO>
+	static constexpr void apply(FROM& from, TO& to)
+	{
+		if constexpr (std::is_const_v<FROM>) { new (&to.m_storage) IE(from.template as<IE>()); }
+		else { new (&to.m_storage) IE(std::move(from.template as<IE>())); }
+		to.m_index = from.index();
+		to.m_stale = TO::num_types;
+	}
+
+	template <class FROM, class TO>
+	static constexpr void apply(FROM&, TO& to) { to.m_stale = TO::num_types; }
+};
+
 struct choice_eq : choice_if
 {
 	template <class IE, class CHOICE>
@@ -163,10 +181,15 @@ struct choice_enc : choice_if
 				if constexpr(std::is_same_v<EXP_TAG, get_field_type_t<meta::list_first_t<typename IE::ies_types>>>)
 				{
 					CODEC_TRACE("explicit[%s] mi=%s", name<EXP_TAG>(), class_name<mi>());
-					//encoode 1st TAG meta-info via exposed
-					sl::ie_encode<type_context<IE_CHOICE>>(encoder, to.template as<EXP_TAG>());
 					//skip 1st TAG meta-info and encode it via exposed
 					using ctx = type_context<IE_CHOICE, meta::list_rest_t<mi>, EXP_TAG>;
+					if constexpr (is_back_to_front_v<ENCODER>)
+					{
+						sl::ie_encode<ctx>(encoder, to.template as<IE>());
+						return sl::ie_encode<type_context<IE_CHOICE>>(encoder, to.template as<EXP_TAG>());
+					}
+					//encoode 1st TAG meta-info via exposed
+					sl::ie_encode<type_context<IE_CHOICE>>(encoder, to.template as<EXP_TAG>());
 					return sl::ie_encode<ctx>(encoder, to.template as<IE>());
 				}
 			}
@@ -182,16 +205,25 @@ struct choice_enc : choice_if
 				//TODO: how to not modify?
 				const_cast<TO&>(to).header().set_tag(tag.get());
 			}
-			med::encode(encoder, to.header());
 			//skip 1st TAG meta-info as it's encoded in header
-			sl::ie_encode<type_context<IE_CHOICE, meta::list_rest_t<mi>>>(encoder, to.template as<IE>());
+			using ctx = type_context<IE_CHOICE, meta::list_rest_t<mi>>;
+			if constexpr (is_back_to_front_v<ENCODER>)
+			{
+				sl::ie_encode<ctx>(encoder, to.template as<IE>());
+				med::encode(encoder, to.header());
+			}
+			else
+			{
+				med::encode(encoder, to.header());
+				sl::ie_encode<ctx>(encoder, to.template as<IE>());
+			}
 		}
 	}
 
 	template <class TO, class ENCODER>
-	static constexpr void apply(TO const& to, ENCODER&)
+	static constexpr void apply(TO const& to, ENCODER& encoder)
 	{
-		MED_THROW_EXCEPTION(unknown_tag, name<TO>(), to.index())
+		MED_RETURN_ERROR(encoder, unknown_tag, name<TO>(), to.index())
 	}
 };
 
@@ -210,10 +242,21 @@ struct choice_dec
 	template <class IE, class TO, class HEADER, class DECODER, class... DEPS>
 	static constexpr void apply(TO& to, HEADER const& header, DECODER& decoder, DEPS&... deps)
 	{
+		using mi = meta::produce_info_t<DECODER, IE>;
+		if constexpr (!is_projected<DECODER, IE>())
+		{
+			//case not in projection is skipped by its length (or decoded if it can't be)
+			constexpr auto kind = get_skip_kind<IE, DECODER>();
+			if constexpr (kind != skip_kind::EAGER && APredefinedValue<get_info_t<meta::list_first_t<mi>>>)
+			{
+				CODEC_TRACE("skip CASE[%s]", name<IE>());
+				return skip_value<IE, kind>(decoder, decoder(GET_STATE{}));
+			}
+		}
+
 		CODEC_TRACE("CASE[%s] %s", name<IE>(), class_name<IE>());
 		auto& ie = static_cast<IE&>(to.template ref<get_field_type_t<IE>>());
 		//skip 1st TAG meta-info as it's decoded in header
-		using mi = meta::produce_info_t<DECODER, IE>;
 		if constexpr (AContainer<IE>)
 		{
 			using FLD_TYPE = get_field_type_t<meta::list_first_t<typename IE::ies_types>>;
@@ -230,9 +273,9 @@ struct choice_dec
 	}
 
 	template <class TO, class HEADER, class DECODER, class... DEPS>
-	constexpr void apply(TO&, HEADER const& header, DECODER&, DEPS&...)
+	constexpr void apply(TO&, HEADER const& header, DECODER& decoder, DEPS&...)
 	{
-		MED_THROW_EXCEPTION(unknown_tag, name<TO>(), get_tag(header))
+		MED_RETURN_ERROR(decoder, unknown_tag, name<TO>(), get_tag(header))
 	}
 };
 
@@ -273,6 +316,8 @@ template <class... IEs>
 class choice : public IE<IE_CHOICE>
 		, public detail::choice_header< meta::list_first_t<meta::typelist<IEs...>> >
 {
+	using header_base = detail::choice_header< meta::list_first_t<meta::typelist<IEs...>> >;
+
 public:
 	using ies_types = conditional_t<
 		AHasGetTag< meta::list_first_t<meta::typelist<IEs...>> >,
@@ -288,6 +333,40 @@ public:
 	template <class T>
 	static constexpr bool has()             { return not std::is_void_v<meta::find_t<ies_types, sl::field_at<T>>>; }
 
+	constexpr choice() = default;
+	//NOTE: the storage is raw so the selected case is copied/moved via its type
+	constexpr choice(choice const& rhs) requires (std::is_copy_constructible_v<IEs> && ...)
+		: header_base(rhs)
+	{ meta::for_if<ies_types>(sl::choice_construct{}, rhs, *this); }
+	constexpr choice& operator=(choice const& rhs) requires (std::is_copy_constructible_v<IEs> && ...)
+	{
+		if (this != &rhs)
+		{
+			reset();
+			header_base::operator=(rhs);
+			meta::for_if<ies_types>(sl::choice_construct{}, rhs, *this);
+		}
+		return *this;
+	}
+	//steals the selected case leaving the source unset
+	constexpr choice(choice&& rhs) noexcept
+		: header_base(std::move(rhs))
+	{
+		meta::for_if<ies_types>(sl::choice_construct{}, rhs, *this);
+		rhs.drop();
+	}
+	constexpr choice& operator=(choice&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			reset();
+			header_base::operator=(std::move(rhs));
+			meta::for_if<ies_types>(sl::choice_construct{}, rhs, *this);
+			rhs.drop();
+		}
+		return *this;
+	}
+
 	//current selected index (type)
 	constexpr std::size_t index() const     { return m_index; }
 	//return index of given type
@@ -297,7 +376,18 @@ public:
 	constexpr void clear()
 	{
 		meta::for_if<ies_types>(sl::choice_clear{}, *this);
-		this->header().clear(); m_index = num_types;
+		reset();
+	}
+	//drops the selection in O(1) w/o walking the case to clear it
+	//NOTE: the cost is moved to the next selection by ref. The case left in
+	//storage is cleared if selected again, which visits only IEs marked as
+	//present in its containers, i.e. none if it wasn't written since then.
+	//Any other case is still value-initialized in full.
+	constexpr void reset()
+	{
+		this->header().clear();
+		if (m_index != num_types) { m_stale = m_index; }
+		m_index = num_types;
 	}
 
 	constexpr bool is_set() const           { return this->header().is_set() && index() != num_types; }
@@ -316,8 +406,10 @@ public:
 		auto* ie = reinterpret_cast<type*>(&m_storage);
 		if (idx != index())
 		{
+			if (idx == m_stale) { ie->clear(); }
+			else { new (&m_storage) type{}; }
 			m_index = idx;
-			new (&m_storage) type{};
+			m_stale = num_types;
 		}
 		return *ie;
 	}
@@ -353,7 +445,7 @@ public:
 		static_assert(std::is_void_v<meta::unique_t<tag_getter<DECODER>, ies_types>>
 			, "SEE ERROR ON INCOMPLETE TYPE/UNDEFINED TEMPLATE HOLDING IEs WITH CLASHED TAGS");
 
-		clear();
+		reset();
 		if constexpr (choice::plain_header)
 		{
 			using IE = meta::list_first_t<ies_types>; //use 1st IE since all have similar tag
@@ -362,13 +454,13 @@ public:
 			CODEC_TRACE("%s CHOICE WITH PLAIN HEADER, mi=%s tag=%s", name<ies_types>(), name<mi>(), name<tag_t>());
 			as_writable_t<tag_t> tag;
 			tag.set_encoded(sl::decode_tag<tag_t>(decoder));
-			meta::for_if<ies_types>(sl::choice_dec{}, *this, tag, decoder, deps...);
+			sl::for_tag<ies_types, DECODER>(get_tag(tag), sl::choice_dec{}, *this, tag, decoder, deps...);
 		}
 		else
 		{
 			CODEC_TRACE("%s CHOICE W/O PLAIN HEADER", name<ies_types>());
 			med::decode(decoder, this->header(), deps...);
-			meta::for_if<ies_types>(sl::choice_dec{}, *this, this->header(), decoder, deps...);
+			sl::for_tag<ies_types, DECODER>(get_tag(this->header()), sl::choice_dec{}, *this, this->header(), decoder, deps...);
 		}
 	}
 
@@ -376,6 +468,7 @@ private:
 	template <class>
 	friend struct sl::choice_len;
 	friend struct sl::choice_copy;
+	friend struct sl::choice_construct;
 	friend struct sl::choice_enc;
 	friend struct sl::choice_dec;
 	friend struct sl::choice_eq;
@@ -385,7 +478,11 @@ private:
 	template <class T> constexpr T& as()                { return *reinterpret_cast<T*>(&m_storage); }
 	template <class T> constexpr T const& as() const    { return *reinterpret_cast<T const*>(&m_storage); }
 
+	//drops the selection and the stale case (e.g. moved out)
+	constexpr void drop()                   { this->header().clear(); m_index = m_stale = num_types; }
+
 	std::size_t  m_index {num_types}; //index of selected type in storage
+	std::size_t  m_stale {num_types}; //index of unselected type left in storage by reset
 	storage_type m_storage;
 };
 
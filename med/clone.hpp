@@ -0,0 +1,80 @@
+/**
+@file
+deep copy of a message into an allocator
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <cstring>
+
+#include "allocator.hpp"
+#include "concepts.hpp"
+#include "exception.hpp"
+
+namespace med {
+
+namespace detail {
+
+//copy context duplicating the external data into its allocator
+template <AAllocator ALLOCATOR, class ERR_POLICY>
+class clone_context : public allocator_holder<ALLOCATOR>
+{
+public:
+	clone_context(ALLOCATOR* alloc, ERR_POLICY& policy) : allocator_holder<ALLOCATOR>{alloc}, m_policy{policy} {}
+
+	//errors are reported via the policy of the caller
+	bool failed() const noexcept                 { return m_policy.failed(); }
+	template <class EX, class... ARGS>
+	void on_error(ARGS&&... args)                { m_policy.template on_error<EX>(std::forward<ARGS>(args)...); }
+
+	uint8_t const* duplicate(uint8_t const* data, std::size_t size)
+	{
+		void* p = this->get_allocator().allocate(size, alignof(uint8_t));
+		if (!p)
+		{
+			raise_error<out_of_memory>(*this, "octets", size);
+			return nullptr;
+		}
+		return static_cast<uint8_t const*>(std::memcpy(p, data, size));
+	}
+
+private:
+	ERR_POLICY& m_policy;
+};
+
+} //end: namespace detail
+
+/**
+ * Deep copy of the message into the allocator (e.g. arena)
+ * @details The copy is laid out in single pass: the message itself is followed
+ * by the external storage of its multi-fields (one allocation per multi-field)
+ * and the external octets so it doesn't refer to the source or its input.
+ * @return pointer to the copy or nullptr when out of space reported via the policy
+ */
+template <class IE, AAllocator ALLOCATOR, class ERR_POLICY>
+IE* clone_into(IE const& from, ALLOCATOR& alloc, ERR_POLICY& policy)
+{
+	detail::clone_context<ALLOCATOR, ERR_POLICY> ctx{&alloc, policy};
+	auto* to = try_create<IE>(alloc);
+	if (!to)
+	{
+		raise_error<out_of_memory>(ctx, name<IE>(), sizeof(IE));
+		return nullptr;
+	}
+	to->copy(from, ctx);
+	return has_failed(ctx) ? nullptr : to;
+}
+
+//same with default error policy
+template <class IE, AAllocator ALLOCATOR>
+IE* clone_into(IE const& from, ALLOCATOR& alloc)
+{
+	default_error_policy policy;
+	return clone_into(from, alloc, policy);
+}
+
+} //end: namespace med
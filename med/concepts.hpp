@@ -80,8 +80,9 @@ concept AField = requires(T v)
 template <class T>
 concept AMultiField = requires(T v)
 {
-	typename T::field_value;
+	typename T::field_type;
 	{ v.count() } -> std::unsigned_integral;
+	{ v.first() };
 	// { v.is_set() } -> std::same_as<bool>;
 	// { v.empty() } -> std::same_as<bool>;
 	// { v.clear() };
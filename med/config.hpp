@@ -12,3 +12,11 @@ Distributed under the MIT License
 //#ifndef CODEC_TRACE_ENABLE
 //#endif
 
+//exceptions are used for error reporting unless disabled (e.g. -fno-exceptions)
+#ifndef MED_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define MED_EXCEPTIONS 1
+#else
+#define MED_EXCEPTIONS 0
+#endif
+#endif
@@ -9,6 +9,9 @@ Distributed under the MIT License
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "debug.hpp"
 #include "accessor.hpp"
 #include "length.hpp"
@@ -21,10 +24,55 @@ namespace med {
 
 namespace sl {
 
+/**
+ * Bitmap of container IEs which may be set
+ * @details a bit is raised when IE is accessed for write or decoded and dropped on
+ * its clear so it's a superset of set IEs: unmarked IE is known to be not set.
+ */
+template <std::size_t N>
+class presence
+{
+public:
+	constexpr void set(std::size_t i)            { m_bits[i / 64] |= word_t{1} << (i % 64); }
+	constexpr void reset(std::size_t i)          { m_bits[i / 64] &= ~(word_t{1} << (i % 64)); }
+	constexpr bool test(std::size_t i) const     { return m_bits[i / 64] & (word_t{1} << (i % 64)); }
+	constexpr void clear()                       { m_bits = {}; }
+
+	constexpr bool any() const
+	{
+		for (auto const w : m_bits) { if (w) { return true; } }
+		return false;
+	}
+
+	//all bits of the mask are set
+	constexpr bool covers(presence const& mask) const
+	{
+		for (std::size_t i = 0; i < num_words; ++i)
+		{
+			if ((m_bits[i] & mask.m_bits[i]) != mask.m_bits[i]) { return false; }
+		}
+		return true;
+	}
+
+	constexpr presence& operator|= (presence const& rhs)
+	{
+		for (std::size_t i = 0; i < num_words; ++i) { m_bits[i] |= rhs.m_bits[i]; }
+		return *this;
+	}
+
+private:
+	using word_t = uint64_t;
+	static constexpr std::size_t num_words = (N + 63) / 64;
+	std::array<word_t, num_words> m_bits{};
+};
+
 struct cont_clear
 {
 	template <class IE, class SEQ>
-	static void apply(SEQ& s)           { static_cast<IE&>(s).clear(); }
+	static void apply(SEQ& s)
+	{
+		if (s.template is_marked<IE>()) { static_cast<IE&>(s).clear(); }
+	}
 };
 
 struct cont_copy
@@ -37,9 +85,15 @@ struct cont_copy
 		if (from_field.is_set())
 		{
 			auto& to_field = to.m_ies.template as<field_t>();
+			to.m_ies.template mark<std::remove_cvref_t<decltype(to_field)>>();
 			if constexpr (AMultiField<IE>)
 			{
 				to_field.clear();
+				//external storage for all fields in single allocation
+				if constexpr (sizeof...(ARGS) > 0)
+				{
+					if (!to_field.reserve(from_field.count(), args...)) { return; }
+				}
 				for (auto const& rhs : from_field)
 				{
 					auto* p = to_field.push_back(std::forward<ARGS>(args)...);
@@ -103,13 +157,13 @@ struct cont_len
 	static constexpr std::size_t apply(SEQ const&, ENCODER&)        { return 0; }
 };
 
+//finds 1st IE which is set
 struct cont_is
 {
-	static constexpr bool op(bool r1, bool r2)  { return r1 || r2; }
-
 	template <class IE, class SEQ>
-	static constexpr bool apply(SEQ const& seq)
+	static constexpr bool check(SEQ const& seq)
 	{
+		if (!seq.template is_marked<IE>()) { return false; }
 		//optional or mandatory field w/ setter => can be set implicitly
 		if constexpr (AOptional<IE> || AHasSetterType<IE>)
 		{
@@ -130,20 +184,25 @@ struct cont_is
 		}
 	}
 
+	template <class IE, class SEQ>
+	static constexpr bool apply(SEQ const&)     { return true; }
+
 	template <class SEQ>
 	static constexpr bool apply(SEQ const&)     { return false; }
 };
 
+//finds 1st IE which differs
 struct cont_eq
 {
-	static constexpr bool op(bool r1, bool r2)  { return r1 && r2; }
-
 	template <class IE, class SEQ>
-	static constexpr bool apply(SEQ const& lhs, SEQ const& rhs)
+	static constexpr bool check(SEQ const& lhs, SEQ const& rhs)
 	{
-		return static_cast<IE const&>(lhs) == static_cast<IE const&>(rhs);
+		return !(static_cast<IE const&>(lhs) == static_cast<IE const&>(rhs));
 	}
 
+	template <class IE, class SEQ>
+	static constexpr bool apply(SEQ const&, SEQ const&)     { return false; }
+
 	template <class SEQ>
 	static constexpr bool apply(SEQ const&, SEQ const&)     { return true; }
 };
@@ -180,6 +239,7 @@ public:
 		static_assert(!std::is_const_v<FIELD>, "ATTEMPT TO COPY FROM CONST REF");
 		auto& ie = m_ies.template as<FIELD>();
 		using IE = std::remove_cvref_t<decltype(ie)>;
+		m_ies.template mark<IE>();
 		if constexpr (AMultiField<IE>)
 		{
 			return static_cast<IE&>(ie);
@@ -204,9 +264,20 @@ public:
 	static constexpr std::size_t arity()    { return sl::field_arity<meta::find_t<ies_types, sl::field_at<FIELD>>>(); }
 
 	template <class FIELD>
-	void clear()                            { m_ies.template as<FIELD>().clear(); }
-	void clear()                            { meta::foreach<ies_types>(sl::cont_clear{}, this->m_ies); }
-	bool is_set() const                     { return meta::fold<ies_types>(sl::cont_is{}, this->m_ies); }
+	void clear()
+	{
+		auto& ie = m_ies.template as<FIELD>();
+		ie.clear();
+		m_ies.template unmark<std::remove_cvref_t<decltype(ie)>>();
+	}
+	//clears only IEs marked as present
+	void clear()
+	{
+		if (!m_ies.present.any()) { return; }
+		meta::foreach<ies_types>(sl::cont_clear{}, this->m_ies);
+		m_ies.present.clear();
+	}
+	bool is_set() const                     { return m_ies.present.any() && meta::for_if<ies_types>(sl::cont_is{}, this->m_ies); }
 	template <class IE_LIST, class TYPE_CTX>
 	std::size_t calc_length(auto& enc) const { return meta::fold<IE_LIST>(sl::cont_len<TYPE_CTX>{}, this->m_ies, enc); }
 	template <class TYPE_CTX = type_context<IE_TYPE>>
@@ -220,13 +291,34 @@ public:
 	void copy_to(TO& to, ARGS&&... args) const
 	{ meta::foreach<ies_types>(sl::cont_copy{}, to, *this, std::forward<ARGS>(args)...); }
 
-	bool operator==(container const& rhs) const { return meta::fold<ies_types>(sl::cont_eq{}, this->m_ies, rhs.m_ies); }
+	bool operator==(container const& rhs) const { return meta::for_if<ies_types>(sl::cont_eq{}, this->m_ies, rhs.m_ies); }
 
 protected:
 	friend struct sl::cont_copy;
 
+	using presence_t = sl::presence<sizeof...(IES)>;
+
+	//presence bits of IEs in the list
+	template <class IE_LIST>
+	static constexpr presence_t presence_of()
+	{
+		return []<template <class...> class L, class... IEs>(L<IEs...>*)
+		{
+			presence_t p;
+			(p.set(meta::list_index_of_v<IEs, ies_types>), ...);
+			return p;
+		}(static_cast<IE_LIST*>(nullptr));
+	}
+
 	struct ies_t : IES...
 	{
+		template <class IE>
+		constexpr void mark()               { present.set(meta::list_index_of_v<IE, ies_types>); }
+		template <class IE>
+		constexpr void unmark()             { present.reset(meta::list_index_of_v<IE, ies_types>); }
+		template <class IE>
+		constexpr bool is_marked() const    { return present.test(meta::list_index_of_v<IE, ies_types>); }
+
 		template <class FIELD>
 		decltype(auto) as() const
 		{
@@ -242,6 +334,8 @@ protected:
 			static_assert(!std::is_void<IE>(), "NO SUCH FIELD");
 			return static_cast<IE&>(*this);
 		}
+
+		presence_t present;
 	};
 
 	ies_t m_ies;
@@ -29,18 +29,18 @@ struct counter_t
 namespace detail {
 
 template <class FUNC, class IE>
-constexpr void check_n_arity(FUNC&, IE const&, std::size_t count)
+constexpr void check_n_arity(FUNC& func, IE const&, std::size_t count)
 {
 	if (count >= IE::min)
 	{
 		if (count > IE::max)
 		{
-			MED_THROW_EXCEPTION(extra_ie, name<IE>(), IE::max, count)
+			MED_RETURN_ERROR(func, extra_ie, name<IE>(), IE::max, count)
 		}
 	}
 	else
 	{
-		MED_THROW_EXCEPTION(missing_ie, name<IE>(), IE::min, count)
+		MED_RETURN_ERROR(func, missing_ie, name<IE>(), IE::min, count)
 	}
 }
 
@@ -73,7 +73,7 @@ void apply_len(DECODER& decoder, IE& ie, DEPS&... deps)
 			{
 				ie_decode<ctx>(decoder, ie, end, deps...);
 				//TODO: ??? as warning not error
-				if (0 != end.size()) { MED_THROW_EXCEPTION(overflow, name<IE>(), end.size()); }
+				if (0 != end.size()) { MED_RETURN_ERROR(decoder, overflow, name<IE>(), end.size()); }
 			}
 			else
 			{
@@ -95,7 +95,7 @@ void apply_len(DECODER& decoder, IE& ie, DEPS&... deps)
 			{
 				ie_decode<ctx>(decoder, ie, deps...);
 				//TODO: ??? as warning not error
-				if (0 != end.size()) { MED_THROW_EXCEPTION(overflow, name<IE>(), end.size()); }
+				if (0 != end.size()) { MED_RETURN_ERROR(decoder, overflow, name<IE>(), end.size()); }
 			}
 			else
 			{
@@ -126,7 +126,7 @@ void apply_len(DECODER& decoder, IE& ie, DEPS&... deps)
 			ie_decode<ctx>(decoder, ie, end, deps...);
 			//TODO: ??? as warning not error
 			CODEC_TRACE("decoded '%s' depends on '%s'", name<LEN_TYPE>(), name<dependency_t>());
-			if (0 != end.size()) { MED_THROW_EXCEPTION(overflow, name<IE>(), end.size()); }
+			if (0 != end.size()) { MED_RETURN_ERROR(decoder, overflow, name<IE>(), end.size()); }
 		}
 		else
 		{
@@ -148,6 +148,7 @@ template <class IE>
 constexpr void explicit_len_commit(auto& decoder, IE& ie, auto& end, auto start)
 {
 	decoder(ie, typename IE::ie_type{});
+	if (has_failed(decoder)) { return; }
 	auto const after_len = decoder(GET_STATE{});
 	auto const delta = after_len - start;
 	auto len = value_to_length(ie) + delta;
@@ -200,7 +201,7 @@ constexpr void ie_decode(DECODER& decoder, IE& ie, DEPS&... deps)
 			if (not info_t::match(tag))
 			{
 				//NOTE: this can only be called for mandatory field thus it's fail case (not unexpected)
-				MED_THROW_EXCEPTION(unknown_tag, name<IE>(), tag)
+				MED_RETURN_ERROR(decoder, unknown_tag, name<IE>(), tag)
 			}
 			ie_decode<type_context<typename TYPE_CTX::ie_type, mi_rest, EXP_TAG, EXP_LEN>>(decoder, ie, deps...);
 		}
@@ -249,11 +250,13 @@ constexpr void ie_decode(DECODER& decoder, IE& ie, DEPS&... deps)
 
 }	//end: namespace sl
 
+//returns status when decoder reports errors w/o exceptions
 template <class DECODER, AHasIeType IE, class... DEPS>
-constexpr void decode(DECODER&& decoder, IE& ie, DEPS&... deps)
+constexpr auto decode(DECODER&& decoder, IE& ie, DEPS&... deps)
 {
 	using META_INFO = meta::produce_info_t<DECODER, IE>;
 	sl::ie_decode<type_context<typename IE::ie_type, META_INFO>>(decoder, ie, deps...);
+	if constexpr (requires { decoder.status(); }) { return decoder.status(); }
 }
 
 }	//end: namespace med
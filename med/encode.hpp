@@ -9,6 +9,7 @@ Distributed under the MIT License
 
 #pragma once
 
+#include <limits>
 #include <utility>
 
 #include "config.hpp"
@@ -35,6 +36,235 @@ constexpr void encode_tag(ENCODER& encoder)
 	encoder(ie, IE_TAG{});
 }
 
+template <class TYPE_CTX, class ENCODER, class IE>
+constexpr void ie_encode(ENCODER& encoder, IE const& ie);
+
+//encoder writing from the end of buffer towards its start (the last IE first)
+template <class ENCODER>
+constexpr bool is_back_to_front_v = requires { requires std::remove_cvref_t<ENCODER>::back_to_front; };
+
+//IEs of the list in order of encoding
+template <class ENCODER, class IE_LIST>
+using encode_order_t = conditional_t<is_back_to_front_v<ENCODER>, meta::list_reverse_t<IE_LIST>, IE_LIST>;
+
+//visits the fields of multi-field in order of encoding until failed
+template <class FUNC, class IE, class VISITOR>
+constexpr void foreach_field(FUNC& func, IE const& ie, VISITOR&& visit)
+{
+	if constexpr (is_back_to_front_v<FUNC>)
+	{
+		//fields are linked forward only: remember a chunk then visit the rest first
+		constexpr std::size_t CHUNK = 32;
+		auto const ite = ie.end();
+		auto visit_from = [&](auto& self, auto from) -> void
+		{
+			typename IE::field_type const* fields[CHUNK];
+			std::size_t num = 0;
+			for (; from != ite && num < CHUNK; ++from) { fields[num++] = &*from; }
+			if (from != ite) { self(self, from); }
+			while (num && not has_failed(func)) { visit(*fields[--num]); }
+		};
+		visit_from(visit_from, ie.begin());
+	}
+	else
+	{
+		for (auto& field : ie)
+		{
+			visit(field);
+			if (has_failed(func)) { return; }
+		}
+	}
+}
+
+/**
+ * Encodes IE before its length when encoding back-to-front
+ * @details the length is known right after the IE is encoded
+ */
+template <class CTX, class LEN_TYPE, class ENCODER, class IE>
+constexpr void encode_length_after(ENCODER& encoder, IE const& ie)
+{
+	static_assert(!APresentIn<LEN_TYPE, IE>, "EXPLICIT LENGTH IS NOT SUPPORTED BACK-TO-FRONT");
+	static_assert(std::is_void_v<typename get_padding<LEN_TYPE>::type>, "PADDING IS NOT SUPPORTED BACK-TO-FRONT");
+
+	auto const end = encoder(GET_STATE{});
+	ie_encode<CTX>(encoder, ie);
+	if (has_failed(encoder)) { return; }
+
+	std::size_t len = std::size_t(end - encoder(GET_STATE{}));
+	using dependency_t = get_dependency_t<LEN_TYPE>;
+	if constexpr (!std::is_void_v<dependency_t>)
+	{
+		auto const delta = LEN_TYPE::dependency(ie.template get<dependency_t>());
+		len -= delta;
+		CODEC_TRACE("adjusted by %d L=%zXh [%s] dependent on %s", -delta, len, name<IE>(), name<dependency_t>());
+	}
+	CODEC_TRACE("LV[%s]=%zX after", name<LEN_TYPE>(), len);
+
+	LEN_TYPE ie_len;
+	length_to_value(encoder, ie_len, len);
+	if (has_failed(encoder)) { return; }
+	encoder(ie_len, IE_LEN{});
+}
+
+constexpr std::size_t NO_OFFSET = std::numeric_limits<std::size_t>::max();
+
+//offset of the field in container if preceded by mandatory fixed-size values only
+template <class FIELD, class ENCODER, class LIST>
+constexpr std::size_t fixed_offset()
+{
+	if constexpr (meta::list_is_empty_v<LIST>)
+	{
+		return NO_OFFSET;
+	}
+	else
+	{
+		using ie_t = meta::list_first_t<LIST>;
+		using field_t = get_field_type_t<ie_t>;
+		if constexpr (std::is_same_v<FIELD, field_t>)
+		{
+			return 0;
+		}
+		else if constexpr (AMandatory<ie_t> && !AMultiField<ie_t>
+			&& std::is_same_v<IE_VALUE, typename field_t::ie_type>
+			&& meta::list_is_empty_v<meta::produce_info_t<ENCODER, ie_t>>)
+		{
+			constexpr auto ofs = fixed_offset<FIELD, ENCODER, meta::list_rest_t<LIST>>();
+			return ofs == NO_OFFSET ? NO_OFFSET : ENCODER::template size_of<field_t>() + ofs;
+		}
+		else
+		{
+			return NO_OFFSET;
+		}
+	}
+}
+
+/**
+ * Checks if the length can be written back after its IE is encoded
+ * (instead of calculating the length in advance)
+ */
+template <class TYPE_CTX, class LEN_TYPE, class ENCODER, class IE>
+constexpr bool can_backpatch()
+{
+	using EXP_TAG = typename TYPE_CTX::explicit_tag_type;
+	using EXP_LEN = typename TYPE_CTX::explicit_length_type;
+
+	if constexpr (not requires { requires ENCODER::backpatch_length; })
+	{
+		return false;
+	}
+	//explicit tag is excluded from the length so it needs to be known
+	else if constexpr (!std::is_void_v<EXP_TAG> && !(AContainer<IE> && APresentIn<EXP_TAG, IE>))
+	{
+		return false;
+	}
+	else if constexpr (APresentIn<LEN_TYPE, IE>)
+	{
+		//explicit length is written back by its offset in container
+		if constexpr (AContainer<IE>)
+		{
+			return fixed_offset<LEN_TYPE, ENCODER, typename IE::ies_types>() != NO_OFFSET;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return std::is_void_v<EXP_LEN>;
+	}
+}
+
+//explicit length field to be set while encoding its container (not a modification of it)
+template <class LEN_TYPE, class IE>
+constexpr auto& explicit_length(IE const& ie)
+{
+	return const_cast<IE&>(ie).IE::container_t::template ref<LEN_TYPE>();
+}
+
+/**
+ * Encodes IE reserving its length and writes the length back after encoding
+ * @details avoids walking the IE twice (for length then for encoding) which
+ * is quadratic in depth of nested length-prefixed IEs
+ */
+template <class TYPE_CTX, class CTX, class LEN_TYPE, class ENCODER, class IE>
+constexpr void encode_backpatched(ENCODER& encoder, IE const& ie)
+{
+	using EXP_TAG = typename TYPE_CTX::explicit_tag_type;
+	using pad_traits = typename get_padding<LEN_TYPE>::type;
+
+	//explicit fields are inside of IE but not accounted in its length
+	std::size_t extra = 0;
+	if constexpr (!std::is_void_v<EXP_TAG> && !std::is_same_v<IE_CHOICE, typename TYPE_CTX::ie_type>)
+	{
+		extra += ENCODER::template size_of<EXP_TAG>();
+	}
+
+	auto const len_state = encoder(GET_STATE{});
+	if constexpr (APresentIn<LEN_TYPE, IE>)
+	{
+		extra += ENCODER::template size_of<LEN_TYPE>();
+		auto& ie_len = explicit_length<LEN_TYPE>(ie);
+		if (not ie_len.is_set()) { ie_len.set_encoded(0); } //placeholder
+	}
+	else
+	{
+		LEN_TYPE const ie_len{}; //placeholder
+		encoder(ie_len, IE_LEN{});
+	}
+
+	auto const start = encoder(GET_STATE{});
+	auto encode_value = [&]
+	{
+		ie_encode<CTX>(encoder, ie);
+		if (has_failed(encoder)) { return; }
+
+		auto const end = encoder(GET_STATE{});
+		std::size_t len = std::size_t(end - start) - extra;
+		using dependency_t = get_dependency_t<LEN_TYPE>;
+		if constexpr (!std::is_void_v<dependency_t>)
+		{
+			auto const delta = LEN_TYPE::dependency(ie.template get<dependency_t>());
+			len -= delta;
+			CODEC_TRACE("adjusted by %d L=%zXh [%s] dependent on %s", -delta, len, name<IE>(), name<dependency_t>());
+		}
+		CODEC_TRACE("backpatch LV[%s]=%zX", name<LEN_TYPE>(), len);
+
+		if constexpr (APresentIn<LEN_TYPE, IE>)
+		{
+			auto& ie_len = explicit_length<LEN_TYPE>(ie);
+			length_to_value(encoder, ie_len, len);
+			if (has_failed(encoder)) { return; }
+			encoder(SET_STATE{}, start);
+			constexpr auto ofs = fixed_offset<LEN_TYPE, ENCODER, typename IE::ies_types>();
+			if constexpr (ofs != 0) { encoder(ADVANCE_STATE{int(ofs)}); }
+			encoder(ie_len, typename LEN_TYPE::ie_type{});
+		}
+		else
+		{
+			LEN_TYPE ie_len;
+			length_to_value(encoder, ie_len, len);
+			if (has_failed(encoder)) { return; }
+			encoder(SET_STATE{}, len_state);
+			encoder(ie_len, IE_LEN{});
+		}
+		encoder(SET_STATE{}, end);
+	};
+
+	if constexpr (!std::is_void_v<pad_traits>)
+	{
+		CODEC_TRACE("padded len_type=%s...:", name<LEN_TYPE>());
+		using pad_t = typename ENCODER::template padder_type<pad_traits, ENCODER>;
+		pad_t pad{encoder};
+		encode_value();
+		pad.add_padding();
+	}
+	else
+	{
+		encode_value();
+	}
+}
+
 template <class TYPE_CTX, class ENCODER, class IE>
 constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 {
@@ -51,7 +281,16 @@ constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 		using ctx = type_context<typename TYPE_CTX::ie_type, meta::list_rest_t<META_INFO>, exp_tag_t, exp_len_t>;
 		CODEC_TRACE("%s[%s]<%s:%s>: %s", __FUNCTION__, name<IE>(), name<exp_tag_t>(), name<exp_len_t>(), class_name<mi>());
 
-		if constexpr (mi::kind == mik::TAG)
+		if constexpr (mi::kind == mik::TAG && is_back_to_front_v<ENCODER>)
+		{
+			ie_encode<ctx>(encoder, ie);
+			if constexpr (!APresentIn<info_t, IE>)
+			{
+				if (not has_failed(encoder)) { encode_tag<info_t>(encoder); }
+			}
+			return;
+		}
+		else if constexpr (mi::kind == mik::TAG)
 		{
 			if constexpr (!APresentIn<info_t, IE>)
 			{
@@ -62,6 +301,14 @@ constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 				CODEC_TRACE("skip explicit T[%s]", name<info_t>());
 			}
 		}
+		else if constexpr (mi::kind == mik::LEN && is_back_to_front_v<ENCODER>)
+		{
+			return encode_length_after<ctx, info_t>(encoder, ie);
+		}
+		else if constexpr (mi::kind == mik::LEN && can_backpatch<TYPE_CTX, info_t, ENCODER, IE>())
+		{
+			return encode_backpatched<TYPE_CTX, ctx, info_t>(encoder, ie);
+		}
 		else if constexpr (mi::kind == mik::LEN)
 		{
 			using len_t = info_t;
@@ -77,15 +324,14 @@ constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 
 			if constexpr (APresentIn<info_t, IE>)
 			{
-				//TODO: a way to avoid cast?
-				auto& ie_len = const_cast<IE&>(ie).template ref<len_t>();
-				length_to_value(ie_len, len);
+				auto& ie_len = explicit_length<len_t>(ie);
+				length_to_value(encoder, ie_len, len);
 				CODEC_TRACE("explicit LV[%s]=%zX", name<len_t>(), std::size_t(ie_len.get_encoded()));
 			}
 			else
 			{
 				len_t ie_len;
-				length_to_value(ie_len, len);
+				length_to_value(encoder, ie_len, len);
 				encoder(ie_len, IE_LEN{});
 			}
 
@@ -134,7 +380,7 @@ constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 		}
 		else
 		{
-			if constexpr (!std::is_same_v<null_allocator, std::remove_const_t<typename ENCODER::allocator_type>>)
+			if constexpr (keeps_snapshots<ENCODER>())
 			{
 				put_snapshot(encoder, ie);
 			}
@@ -145,12 +391,21 @@ constexpr void ie_encode(ENCODER& encoder, IE const& ie)
 
 }	//end: namespace sl
 
+//exact size of encoded IE to reserve the space before encoding (see unchecked_buffer)
+template <class ENCODER, AHasIeType IE>
+constexpr std::size_t encoded_size(ENCODER&& encoder, IE const& ie)
+{
+	return field_length(ie, encoder);
+}
+
+//returns status when encoder reports errors w/o exceptions
 template <class ENCODER, AHasIeType IE>
-constexpr void encode(ENCODER&& encoder, IE const& ie)
+constexpr auto encode(ENCODER&& encoder, IE const& ie)
 {
 	using META_INFO = meta::produce_info_t<ENCODER, IE>;
 	CODEC_TRACE("mi=%s by %s for %s", class_name<META_INFO>(), class_name<ENCODER>(), class_name<IE>());
 	sl::ie_encode<type_context<typename IE::ie_type, META_INFO>>(encoder, ie);
+	if constexpr (requires { encoder.status(); }) { return encoder.status(); }
 }
 
 }	//end: namespace med
@@ -0,0 +1,217 @@
+/**
+@file
+compile-time bounds of encoded size of IE
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "concepts.hpp"
+#include "ie_type.hpp"
+#include "padding.hpp"
+#include "octet_string.hpp"
+#include "bit_string.hpp"
+#include "sl/octet_info.hpp"
+#include "meta/typelist.hpp"
+
+namespace med {
+
+//size which can't be bound at compile-time (e.g. multi-field of inf or unlimited string)
+inline constexpr std::size_t unbounded_size = std::numeric_limits<std::size_t>::max();
+
+namespace sl {
+
+//range of encoded size in bits
+struct size_range
+{
+	std::size_t min;
+	std::size_t max;
+
+	static constexpr std::size_t add(std::size_t a, std::size_t b)
+	{
+		return (a == unbounded_size || b > unbounded_size - a) ? unbounded_size : a + b;
+	}
+	static constexpr std::size_t mul(std::size_t a, std::size_t n)
+	{
+		return (n && a > unbounded_size / n) ? unbounded_size : a * n;
+	}
+
+	constexpr size_range operator+(size_range const& rhs) const
+	{
+		return {add(min, rhs.min), add(max, rhs.max)};
+	}
+	//union of alternatives
+	constexpr size_range operator|(size_range const& rhs) const
+	{
+		return {std::min(min, rhs.min), std::max(max, rhs.max)};
+	}
+};
+
+template <class CODEC, class META_INFO, class IE>
+constexpr size_range meta_size_range();
+
+template <class CODEC, class FIELD>
+constexpr size_range field_size_range();
+
+//IE of container (optional and/or multi-instance)
+template <class CODEC, class IE>
+constexpr size_range member_size_range()
+{
+	if constexpr (AMultiField<IE>)
+	{
+		using field_t = typename IE::field_type;
+		constexpr auto one = meta_size_range<CODEC, meta::produce_info_t<CODEC, field_t>, field_t>();
+		constexpr std::size_t min_count = AOptional<IE> ? 0 : IE::min;
+		constexpr std::size_t max_count = (IE::max == inf::value) ? unbounded_size : IE::max;
+		size_range r{size_range::mul(one.min, min_count), size_range::mul(one.max, max_count)};
+		if constexpr (ACounter<IE>)
+		{
+			constexpr std::size_t bits = IE::counter_type::traits::bits;
+			r = r + size_range{min_count ? bits : 0, bits};
+		}
+		return r;
+	}
+	else
+	{
+		constexpr auto r = meta_size_range<CODEC, meta::produce_info_t<CODEC, IE>, IE>();
+		return {AOptional<IE> ? 0 : r.min, r.max};
+	}
+}
+
+template <class CODEC, class IE_LIST>
+struct list_size_range;
+
+template <class CODEC, template <class...> class L, class... IEs>
+struct list_size_range<CODEC, L<IEs...>>
+{
+	//all IEs of sequence or set
+	static constexpr size_range sum()
+	{
+		return (size_range{0, 0} + ... + member_size_range<CODEC, IEs>());
+	}
+	//one of choice alternatives (w/o tag if it's in compound header)
+	template <bool PLAIN_HEADER>
+	static constexpr size_range any()
+	{
+		return (size_range{unbounded_size, 0} | ... | alternative<PLAIN_HEADER, IEs>());
+	}
+
+private:
+	template <bool PLAIN_HEADER, class IE>
+	static constexpr size_range alternative()
+	{
+		using mi = meta::produce_info_t<CODEC, IE>;
+		return meta_size_range<CODEC, conditional_t<PLAIN_HEADER, mi, meta::list_rest_t<mi>>, IE>();
+	}
+};
+
+template <class CODEC, class FIELD>
+constexpr size_range field_size_range()
+{
+	using ie_type = typename FIELD::ie_type;
+	if constexpr (std::is_same_v<IE_CHOICE, ie_type>)
+	{
+		using list = list_size_range<CODEC, typename FIELD::ies_types>;
+		if constexpr (FIELD::plain_header)
+		{
+			return list::template any<true>();
+		}
+		else
+		{
+			using header_t = typename FIELD::header_type;
+			return meta_size_range<CODEC, meta::produce_info_t<CODEC, header_t>, header_t>() + list::template any<false>();
+		}
+	}
+	else if constexpr (std::is_same_v<IE_SEQUENCE, ie_type> || std::is_same_v<IE_SET, ie_type>)
+	{
+		return list_size_range<CODEC, typename FIELD::ies_types>::sum();
+	}
+	else if constexpr (std::is_same_v<IE_VALUE, ie_type>)
+	{
+		return {FIELD::traits::bits, FIELD::traits::bits};
+	}
+	else if constexpr (std::is_same_v<IE_OCTET_STRING, ie_type>)
+	{
+		using traits = typename FIELD::traits;
+		return {8 * traits::min_octets, traits::max_octets == MAX_OCTS ? unbounded_size : 8 * traits::max_octets};
+	}
+	else if constexpr (std::is_same_v<IE_BIT_STRING, ie_type>)
+	{
+		using traits = typename FIELD::traits;
+		return {traits::min_bits, traits::max_bits == MAX_BITS ? unbounded_size : traits::max_bits};
+	}
+	else if constexpr (std::is_same_v<IE_NULL, ie_type>)
+	{
+		return {0, 0};
+	}
+	else
+	{
+		return {0, unbounded_size};
+	}
+}
+
+//IE preceded by its tag and/or length
+template <class CODEC, class META_INFO, class IE>
+constexpr size_range meta_size_range()
+{
+	if constexpr (meta::list_is_empty_v<META_INFO>)
+	{
+		return field_size_range<CODEC, get_field_type_t<IE>>();
+	}
+	else
+	{
+		using mi = meta::list_first_t<META_INFO>;
+		using info_t = get_info_t<mi>;
+		constexpr auto r = meta_size_range<CODEC, meta::list_rest_t<META_INFO>, IE>();
+		//explicit tag or length is accounted as field of container
+		if constexpr (APresentIn<info_t, IE>)
+		{
+			return r;
+		}
+		else
+		{
+			constexpr std::size_t bits = info_t::traits::bits;
+			using pad_traits = typename get_padding<info_t>::type;
+			if constexpr (mi::kind == mik::LEN && !std::is_void_v<pad_traits>)
+			{
+				//padding up to its unit excluding an octet at least
+				return r + size_range{bits, bits + pad_traits::pad_bits - 8};
+			}
+			else
+			{
+				return r + size_range{bits, bits};
+			}
+		}
+	}
+}
+
+template <class IE, class CODEC>
+constexpr size_range encoded_size_range()
+{
+	constexpr auto r = meta_size_range<CODEC, meta::produce_info_t<CODEC, IE>, IE>();
+	return {bits_to_bytes(r.min), r.max == unbounded_size ? unbounded_size : bits_to_bytes(r.max)};
+}
+
+} //end: namespace sl
+
+/**
+ * Bounds of encoded size of IE (e.g. message) in octets
+ * @details Computed from the bits of values, the limits of strings and
+ * multi-fields and the alternatives of choices along with tags and lengths
+ * of the CODEC. The maximum is unbounded_size if IE has no upper limit.
+ * Can be used to size the buffers statically or to reject truncated input
+ * before decoding.
+ */
+template <class IE, class CODEC = sl::octet_info>
+inline constexpr std::size_t max_encoded_size_v = sl::encoded_size_range<IE, CODEC>().max;
+
+template <class IE, class CODEC = sl::octet_info>
+inline constexpr std::size_t min_encoded_size_v = sl::encoded_size_range<IE, CODEC>().min;
+
+} //end: namespace med
@@ -60,16 +60,19 @@ public:
 	/**
 	 * Stores the buffer snapshot
 	 * @param snap
+	 * @return false if no space to store the snapshot
 	 */
-	constexpr void put_snapshot(SNAPSHOT snap)
+	constexpr bool put_snapshot(SNAPSHOT snap)
 	{
 		CODEC_TRACE("snapshot %p{%zu}", static_cast<void const*>(snap.id), snap.size);
-		snapshot_s* p = create<snapshot_s>(this->get_allocator());
+		snapshot_s* p = try_create<snapshot_s>(this->get_allocator());
+		if (!p) { return false; }
 		p->snapshot = snap;
 		p->state = m_buffer.get_state();
 
 		p->next = m_snapshot ? m_snapshot->next : nullptr;
 		m_snapshot = p;
+		return true;
 	}
 
 	class snap_s : public state_t
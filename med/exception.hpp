@@ -11,6 +11,7 @@ Distributed under the MIT License
 
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <type_traits>
@@ -20,6 +21,36 @@ Distributed under the MIT License
 
 namespace med {
 
+//codes of errors reported either via exceptions or status
+enum class error : uint8_t
+{
+	success,
+	overflow,
+	invalid_value,
+	unknown_tag,
+	missing_ie,
+	extra_ie,
+	out_of_memory,
+};
+
+namespace detail {
+
+constexpr char const* error_format(error code)
+{
+	switch (code)
+	{
+	case error::overflow:      return "'%.64s' needs %zu octets.";
+	case error::invalid_value: return "Invalid value of '%.64s' = 0x%zX.";
+	case error::unknown_tag:   return "Unknown tag of '%.64s' = 0x%zX.";
+	case error::missing_ie:    return "Missing IE '%.64s': at least %zu expected, got %zu.";
+	case error::extra_ie:      return "Excessive IE '%.64s': no more than %zu expected, got %zu.";
+	case error::out_of_memory: return "No space to allocate '%.64s': %zu octets.";
+	default:                   return "";
+	}
+}
+
+} //end: namespace detail
+
 class exception : public std::exception
 {
 public:
@@ -48,8 +79,10 @@ protected:
 //OVERFLOW
 struct overflow : exception
 {
+	static constexpr error code = error::overflow;
+
 	overflow(char const* name, std::size_t bytes, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "'%.64s' needs %zu octets.", name, bytes); }
+		{ format(bufpos, detail::error_format(code), name, bytes); }
 
 	template <class CTX>
 	overflow(char const* name, std::size_t bytes, CTX const& ctx) noexcept
@@ -60,8 +93,10 @@ struct value_exception : public exception {};
 
 struct invalid_value : public value_exception
 {
+	static constexpr error code = error::invalid_value;
+
 	invalid_value(char const* name, std::size_t val, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "Invalid value of '%.64s' = 0x%zX.", name, val); }
+		{ format(bufpos, detail::error_format(code), name, val); }
 
 	template <class CTX>
 	invalid_value(char const* name, std::size_t val, CTX const& ctx) noexcept
@@ -69,8 +104,10 @@ struct invalid_value : public value_exception
 };
 struct unknown_tag : public value_exception
 {
+	static constexpr error code = error::unknown_tag;
+
 	unknown_tag(char const* name, std::size_t val, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "Unknown tag of '%.64s' = 0x%zX.", name, val); }
+		{ format(bufpos, detail::error_format(code), name, val); }
 
 	template <class CTX>
 	unknown_tag(char const* name, std::size_t val, CTX const& ctx) noexcept
@@ -81,8 +118,10 @@ struct ie_exception : public exception {};
 
 struct missing_ie : public ie_exception
 {
+	static constexpr error code = error::missing_ie;
+
 	missing_ie(char const* name, std::size_t exp, std::size_t got, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "Missing IE '%.64s': at least %zu expected, got %zu.", name, exp, got); }
+		{ format(bufpos, detail::error_format(code), name, exp, got); }
 
 	template <class CTX>
 	missing_ie(char const* name, std::size_t exp, std::size_t got, CTX const& ctx) noexcept
@@ -90,8 +129,10 @@ struct missing_ie : public ie_exception
 };
 struct extra_ie : public ie_exception
 {
+	static constexpr error code = error::extra_ie;
+
 	extra_ie(char const* name, std::size_t exp, std::size_t got, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "Excessive IE '%.64s': no more than %zu expected, got %zu.", name, exp, got); }
+		{ format(bufpos, detail::error_format(code), name, exp, got); }
 
 	template <class CTX>
 	extra_ie(char const* name, std::size_t exp, std::size_t got, CTX const& ctx) noexcept
@@ -101,14 +142,139 @@ struct extra_ie : public ie_exception
 //OUT_OF_MEMORY
 struct out_of_memory : public exception
 {
+	static constexpr error code = error::out_of_memory;
+
 	out_of_memory(char const* name, std::size_t bytes, char const* bufpos = nullptr) noexcept
-		{ format(bufpos, "No space to allocate '%.64s': %zu octets.", name, bytes); }
+		{ format(bufpos, detail::error_format(code), name, bytes); }
 
 	template <class CTX>
 	out_of_memory(char const* name, std::size_t bytes, CTX const& ctx) noexcept
 		: out_of_memory{name, bytes, ctx.toString()} {}
 };
 
+#if MED_EXCEPTIONS
 #define MED_THROW_EXCEPTION(ex, ...) { CODEC_TRACE("THROW: %s", #ex); throw ex(__VA_ARGS__); }
+#else
+#define MED_THROW_EXCEPTION(ex, ...) { CODEC_TRACE("ABORT: %s", #ex); std::abort(); }
+#endif
+
+/**
+ * Result of encode/decode w/o exceptions.
+ * Holds the 1st error only and formats its text on demand.
+ */
+class status
+{
+public:
+	constexpr explicit operator bool() const noexcept  { return error::success == m_code; }
+	constexpr error code() const noexcept              { return m_code; }
+	constexpr char const* name() const noexcept        { return m_name; }
+
+	constexpr void reset() noexcept                    { *this = status{}; }
+	constexpr void set(error code, char const* name, std::size_t v1, std::size_t v2 = 0) noexcept
+	{
+		if (*this)
+		{
+			m_code = code;
+			m_name = name;
+			m_value[0] = v1;
+			m_value[1] = v2;
+		}
+	}
+
+	//same text as in the exception::what()
+	char const* format(char* out, std::size_t size) const noexcept
+	{
+		if (size)
+		{
+			std::snprintf(out, size, detail::error_format(m_code), m_name, m_value[0], m_value[1]);
+		}
+		return out;
+	}
+
+private:
+	error       m_code{error::success};
+	char const* m_name{""};
+	std::size_t m_value[2]{};
+};
+
+//error policy to report errors via exceptions
+struct throw_on_error
+{
+	static constexpr bool failed() noexcept          { return false; }
+
+	template <class EX, class... ARGS>
+	[[noreturn, gnu::cold, gnu::noinline]] static void on_error(ARGS&&... args)
+	{
+		MED_THROW_EXCEPTION(EX, std::forward<ARGS>(args)...)
+	}
+};
+
+//error policy to report errors via status
+class status_on_error
+{
+public:
+	constexpr bool failed() const noexcept             { return not m_status; }
+	constexpr med::status const& status() const noexcept { return m_status; }
+	constexpr void reset_status() noexcept             { m_status.reset(); }
+
+	template <class EX, class... ARGS>
+	constexpr void on_error(char const* name, std::size_t v1, ARGS const&... args) noexcept
+	{
+		CODEC_TRACE("ERROR: %s %s", detail::error_format(EX::code), name);
+		m_status.set(EX::code, name, v1, second_value(args...));
+	}
+
+private:
+	static constexpr std::size_t second_value()        { return 0; }
+	template <class T, class... ARGS>
+	static constexpr std::size_t second_value(T const& v, ARGS const&...)
+	{
+		if constexpr (std::is_integral_v<T>) { return v; }
+		else { return 0; }
+	}
+
+	med::status m_status;
+};
+
+using default_error_policy = std::conditional_t<MED_EXCEPTIONS, throw_on_error, status_on_error>;
+
+/**
+ * Mixes the error policy into a codec which stops processing its buffer
+ * after an error reported w/o exception
+ */
+template <class CODEC, class ERR_POLICY>
+struct error_handler : ERR_POLICY
+{
+	template <class EX, class... ARGS>
+	constexpr void on_error(ARGS&&... args)
+	{
+		ERR_POLICY::template on_error<EX>(std::forward<ARGS>(args)...);
+		static_cast<CODEC*>(this)->get_context().buffer().halt();
+	}
+};
+
+//reports error via codec's policy or throws if codec has none
+template <class EX, class FUNC, class... ARGS>
+constexpr void raise_error(FUNC& func, ARGS&&... args)
+{
+	if constexpr (requires { func.failed(); })
+	{
+		func.template on_error<EX>(std::forward<ARGS>(args)...);
+	}
+	else
+	{
+		MED_THROW_EXCEPTION(EX, std::forward<ARGS>(args)...)
+	}
+}
+
+//checks if error was reported w/o exception
+template <class FUNC>
+constexpr bool has_failed(FUNC const& func) noexcept
+{
+	if constexpr (requires { func.failed(); }) { return func.failed(); }
+	else { return false; }
+}
+
+#define MED_RETURN_ERROR(func, ex, ...) { return ::med::raise_error<ex>(func, __VA_ARGS__); }
 
 }	//end: namespace med
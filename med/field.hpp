@@ -11,7 +11,10 @@ Distributed under the MIT License
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <iterator>
+#include <limits>
 
 #include "ie_type.hpp"
 #include "name.hpp"
@@ -20,6 +23,7 @@ Distributed under the MIT License
 #include "meta/typelist.hpp"
 #include "allocator.hpp"
 #include "concepts.hpp"
+#include "offset_ptr.hpp"
 
 
 namespace med {
@@ -66,12 +70,6 @@ public:
 	using ie_type = typename FIELD::ie_type;
 	using field_type = field_t<FIELD, FIELD_META_INFO...>;
 
-	struct field_value
-	{
-		field_type   value;
-		field_value* next;
-	};
-
 	static constexpr std::size_t min = MIN;
 	static constexpr std::size_t max = CMAX::value;
 	static constexpr std::size_t inplace = detail::get_inplace<MIN, CMAX>::value;
@@ -79,132 +77,203 @@ public:
 	multi_field(multi_field const&) = delete;
 	multi_field& operator= (multi_field const&) = delete;
 	multi_field() = default;
+	//steals external storage while inplace fields are moved
+	multi_field(multi_field&& rhs) noexcept                 { steal(rhs); }
+	multi_field& operator= (multi_field&& rhs) noexcept
+	{
+		if (this != &rhs)
+		{
+			clear();
+			steal(rhs);
+		}
+		return *this;
+	}
 
 private:
+	//external storage is a number of blocks each twice bigger than previous
+	//while the last one takes the rest up to max (so up to SIZE_MAX for inf)
+	static constexpr std::size_t external = max - inplace;
+	static constexpr std::size_t block_base = std::min<std::size_t>(external, inplace < 4 ? 4 : inplace);
+	//block of double size can be computed w/o overflow
+	static constexpr bool can_double(std::size_t k)             { return std::bit_width(block_base) + k < std::numeric_limits<std::size_t>::digits; }
+	static constexpr std::size_t num_blocks = []
+	{
+		std::size_t num = 0;
+		for (std::size_t cap = 0; cap < external; ++num)
+		{
+			cap = (can_double(num) && (block_base << num) < external - cap) ? cap + (block_base << num) : external;
+		}
+		return num;
+	}();
+
+	//start index of the block in external storage
+	static constexpr std::size_t block_start(std::size_t k)     { return block_base * ((std::size_t{1} << k) - 1); }
+	static constexpr std::size_t block_size(std::size_t k)
+	{
+		auto const rest = external - block_start(k);
+		return can_double(k) ? std::min(block_base << k, rest) : rest;
+	}
+	//index of the block for the index in external storage
+	static constexpr std::size_t block_of(std::size_t idx)      { return std::bit_width(idx / block_base + 1) - 1; }
+
+	//pointers to first few blocks are kept inplace while the rest of them (e.g. for inf)
+	//are in a table allocated from the context once the inplace blocks are exhausted
+	static constexpr std::size_t inplace_blocks = std::min<std::size_t>(num_blocks, 4);
+	static constexpr bool has_more_blocks = num_blocks > inplace_blocks;
+	using block_ptr = offset_ptr<field_type>;
+	struct no_more_blocks {};
+	using more_blocks = conditional_t<has_more_blocks, offset_ptr<block_ptr>, no_more_blocks>;
+
+	block_ptr& block(std::size_t k)
+	{
+		if constexpr (has_more_blocks)
+		{
+			if (k >= inplace_blocks) { return m_more[k - inplace_blocks]; }
+		}
+		return m_blocks[k];
+	}
+
 	template <class T>
 	class iter_type
 	{
 	public:
 		using iterator_category = std::forward_iterator_tag;
-		using value_type = T;
+		using value_type = field_type;
 		using difference_type = std::ptrdiff_t;
 		using pointer = conditional_t<std::is_const_v<T>, field_type const*, field_type*>;
 		using reference = conditional_t<std::is_const_v<T>, field_type const&, field_type&>;
 
-		explicit iter_type(value_type* p = nullptr) : m_curr{p} { }
-		iter_type& operator++()                     { m_curr = m_curr ? m_curr->next : nullptr; return *this; }
+		explicit iter_type(T* owner = nullptr, std::size_t idx = 0) : m_owner{owner}, m_idx{idx} { }
+		iter_type& operator++()                     { ++m_idx; return *this; }
 		iter_type operator++(int)                   { iter_type ret = *this; ++(*this); return ret;}
-		bool operator==(iter_type const& rhs) const { return m_curr == rhs.m_curr; }
+		bool operator==(iter_type const& rhs) const { return get() == rhs.get(); }
 		bool operator!=(iter_type const& rhs) const { return !(*this == rhs); }
 		reference operator*() const                 { return *get(); }
 		pointer operator->() const                  { return get(); }
-		pointer get() const                         { return m_curr ? &m_curr->value : nullptr; }
-		explicit operator bool() const              { return nullptr != m_curr; }
+		pointer get() const                         { return *this ? &(*m_owner)[m_idx] : nullptr; }
+		explicit operator bool() const              { return m_owner && m_idx < m_owner->count(); }
 
 	private:
 		template <AField, std::size_t, class, class, class...> friend class multi_field;
-		value_type* m_curr;
+		T*          m_owner;
+		std::size_t m_idx;
 	};
 
 public:
-	using iterator = iter_type<field_value>;
-	iterator begin()                                        { return iterator{m_head}; }
-	iterator end()                                          { return iterator{}; }
-	using const_iterator = iter_type<field_value const>;
-	const_iterator begin() const                            { return const_iterator{m_head}; }
-	const_iterator end() const                              { return const_iterator{}; }
+	using iterator = iter_type<multi_field>;
+	iterator begin()                                        { return iterator{this}; }
+	iterator end()                                          { return iterator{this, count()}; }
+	using const_iterator = iter_type<multi_field const>;
+	const_iterator begin() const                            { return const_iterator{this}; }
+	const_iterator end() const                              { return const_iterator{this, count()}; }
 
 	std::size_t count() const                               { return m_count; }
-	bool empty() const                                      { return nullptr == m_head; }
-	//NOTE: clear won't return items allocated from external storage, use reset there
+	bool empty() const                                      { return 0 == m_count; }
+	//NOTE: clear won't return external storage to its allocator, use reset there
 	void clear()
 	{
 		for (auto& v : *this) { v.clear(); }
-		m_head = m_tail = nullptr;
 		m_count = 0;
+		m_blocks = {};
+		m_more = more_blocks{};
 	}
-	bool is_set() const                                     { return not empty() && m_head->value.is_set(); }
+	bool is_set() const                                     { return not empty() && first()->is_set(); }
 
-	field_type* first()                                     { return empty() ? nullptr : &m_head->value; }
-	field_type* last()                                      { return empty() ? nullptr : &m_tail->value; }
+	//NOTE: no range check
+	field_type& operator[](std::size_t idx)
+	{
+		if constexpr (num_blocks > 0)
+		{
+			if (idx >= inplace)
+			{
+				idx -= inplace;
+				auto const k = block_of(idx);
+				return block(k)[idx - block_start(k)];
+			}
+		}
+		return m_fields[idx];
+	}
+	field_type const& operator[](std::size_t idx) const     { return (*const_cast<multi_field*>(this))[idx]; }
+
+	field_type* first()                                     { return empty() ? nullptr : &(*this)[0]; }
+	field_type* last()                                      { return empty() ? nullptr : &(*this)[count() - 1]; }
 	field_type const* first() const                         { return const_cast<multi_field*>(this)->first(); }
 	field_type const* last() const                          { return const_cast<multi_field*>(this)->last(); }
 
 	//uses inplace storage only
-	field_type* push_back()                                 { return append(get_free_inplace()); }
+	field_type* push_back()
+	{
+		if (count() < inplace) { return append(); }
+		MED_THROW_EXCEPTION(out_of_memory, name<field_type>(), sizeof(field_type))
+	}
 
 	//uses inplace or external storage
 	//NOTE: check for max is done during encode/decode
 	template <class CTX> field_type* push_back(CTX& ctx)
 	{
-		auto* pf = get_free_inplace(); //try inplace 1st then external
-		return append(pf ? pf : create<field_value>(get_allocator(ctx)));
+		return reserve(count() + 1, ctx) ? append() : nullptr;
 	}
 
-	//won't recover space if external storage was used
-	void pop_back()
+	//allocates external storage for the total number of fields at once
+	template <class CTX> bool reserve(std::size_t num, CTX& ctx)
 	{
-		if (auto* prev = m_head)
+		if (num <= inplace) { return true; }
+		if constexpr (num_blocks > 0)
 		{
-			//clear the last
-			--m_count;
-			m_tail->value.clear();
-
-			//locate previous before last
-			for (std::size_t i = 1; i < count(); ++i)
+			if (num <= max)
 			{
-				//CODEC_TRACE("%s: %s[%zu]=%p", __FUNCTION__, name<field_type>(), i, (void*)prev->next);
-				prev = prev->next;
-			}
-
-			if (count())
-			{
-				prev->next->value.clear();
-				m_tail = (count()) ? prev : nullptr;
-			}
-			else
-			{
-				m_head = m_tail = nullptr;
+				auto const last = block_of(num - inplace - 1);
+				if constexpr (has_more_blocks)
+				{
+					if (last >= inplace_blocks && !m_more)
+					{
+						constexpr auto num_more = num_blocks - inplace_blocks;
+						m_more = try_create_n<block_ptr>(get_allocator(ctx), num_more);
+						if (!m_more)
+						{
+							raise_error<out_of_memory>(ctx, name<field_type>(), num_more * sizeof(block_ptr));
+							return false;
+						}
+					}
+				}
+				if (block(last)) { return true; }
+				std::size_t first = last;
+				while (first > 0 && !block(first - 1)) { --first; }
+				//single allocation for all missing blocks
+				auto const size = block_start(last) + block_size(last) - block_start(first);
+				if (auto* p = try_create_n<field_type>(get_allocator(ctx), size))
+				{
+					for (auto k = first; k <= last; ++k, p += block_size(k - 1)) { block(k) = p; }
+					return true;
+				}
+				raise_error<out_of_memory>(ctx, name<field_type>(), size * sizeof(field_type));
+				return false;
 			}
-
-			prev->next = nullptr;
 		}
+		raise_error<extra_ie>(ctx, name<field_type>(), max, num);
+		return false;
 	}
 
-	iterator erase(iterator pos)
+	//won't recover space if external storage was used
+	void pop_back()
 	{
-		for (auto it = begin(), prev = it; it; ++it)
+		if (!empty())
 		{
-			if (it == pos)
-			{
-				--m_count;
-				it.m_curr->value.clear();
-				iterator ret;
-				if (!m_count) { ret = iterator(m_head = m_tail = nullptr); }
-				else
-				{
-					if (it == prev) //1st
-					{
-						m_head = m_head->next;
-						ret = begin();
-					}
-					else
-					{
-						prev.m_curr->next = it.m_curr->next;
-						ret = std::next(prev);
-					}
-					if (m_tail == it.m_curr) //last
-					{
-						m_tail = prev.m_curr;
-					}
-				}
-				CODEC_TRACE("%s(%s=%p) count=%zu head=%p tail=%p", __FUNCTION__, name<field_type>(), (void*)it.get(), count(), (void*)m_head, (void*)m_tail);
-				return ret;
-			}
-			prev = it;
+			(*this)[--m_count].clear();
+			CODEC_TRACE("%s(%s) count=%zu", __FUNCTION__, name<field_type>(), count());
 		}
-		CODEC_TRACE("%s: %s[%c]", __FUNCTION__, name<field_type>(), '-');
-		return end();
+	}
+
+	//NOTE: fields after erased one are moved down by one (external storage of
+	//nested multi-fields is stolen) so iterators, pointers and references to
+	//them are invalidated as for std::vector
+	iterator erase(iterator pos)
+	{
+		if (!pos) { return end(); }
+		std::move(std::next(pos), end(), pos);
+		pop_back();
+		CODEC_TRACE("%s(%s[%zu]) count=%zu", __FUNCTION__, name<field_type>(), pos.m_idx, count());
+		return iterator{this, pos.m_idx};
 	}
 
 	bool operator==(multi_field const& rhs) const noexcept
@@ -213,36 +282,33 @@ public:
 	}
 
 private:
-	//find unset inplace slot
-	field_value* get_free_inplace()
+	void steal(multi_field& rhs) noexcept
 	{
-		if (count() < inplace)
+		auto const num = std::min(rhs.count(), inplace);
+		for (std::size_t i = 0; i < num; ++i)
 		{
-			for (auto& f : m_fields)
-			{
-				// CODEC_TRACE("%s: %s=%p[%c][%zu]", __FUNCTION__, name<field_type>(), (void*)&f, f.value.is_set()?'+':'-', inplace);
-				if (!f.value.is_set()) return &f;
-			}
+			m_fields[i] = std::move(rhs.m_fields[i]);
+			rhs.m_fields[i].clear();
 		}
-		return nullptr;
+		m_count = rhs.m_count;
+		m_blocks = rhs.m_blocks;
+		m_more = rhs.m_more;
+		rhs.m_count = 0;
+		rhs.m_blocks = {};
+		rhs.m_more = more_blocks{};
 	}
 
-	field_type* append(field_value* pf)
+	field_type* append()
 	{
-		if (!pf) { MED_THROW_EXCEPTION(out_of_memory, name<field_type>(), sizeof(field_type)) }
-
-		if (m_count++) { m_tail->next = pf; }
-		else { m_head = m_tail = pf; }
-		pf->next = nullptr;
-		m_tail = pf;
-		CODEC_TRACE("%s(%s=%p) count=%zu head=%p tail=%p", __FUNCTION__, name<field_type>(), (void*)pf, count(), (void*)m_head, (void*)m_tail);
-		return &m_tail->value;
+		auto* pf = &(*this)[m_count++];
+		CODEC_TRACE("%s(%s=%p) count=%zu", __FUNCTION__, name<field_type>(), (void*)pf, count());
+		return pf;
 	}
 
-	field_value* m_head {nullptr};
-	field_value* m_tail {nullptr};
-	std::size_t  m_count {0};
-	field_value  m_fields[inplace];
+	std::size_t                                        m_count {0};
+	std::array<block_ptr, inplace_blocks>              m_blocks {};
+	[[no_unique_address]] more_blocks                  m_more {};
+	field_type                                         m_fields[inplace];
 };
 
 }	//end: namespace med
@@ -0,0 +1,126 @@
+/**
+@file
+encoder buffer producing scatter-gather (iovec) output
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include "buffer.hpp"
+
+namespace med {
+
+/**
+ * Encoder buffer which references large octet strings in place instead of copying.
+ * @details Everything else is encoded into the scratch buffer as usual which is split
+ * into segments around the referenced strings. The resulting chain of segments can be
+ * passed directly to writev/sendmsg.
+ * NOTE: the referenced data (and the encoded message if strings have internal storage)
+ * must outlive the chain.
+ */
+template <std::size_t MAX_SEGMENTS = 16, std::size_t LEN_DEPTH = 16>
+class iovec_buffer : public buffer<uint8_t, LEN_DEPTH>
+{
+	static_assert(MAX_SEGMENTS >= 3, "AT LEAST 3 SEGMENTS ARE REQUIRED TO REFERENCE A STRING");
+	using base_t = buffer<uint8_t, LEN_DEPTH>;
+
+public:
+	//default minimal size of octet string to be referenced in place
+	static constexpr std::size_t DEFAULT_THRESHOLD = 64;
+
+	//buffer state accounts the referenced octets and segments too
+	class state_type : public base_t::state_type
+	{
+	public:
+		constexpr state_type() noexcept = default;
+
+		friend constexpr std::ptrdiff_t operator- (state_type const& rhs, state_type const& lhs)
+		{
+			using base_state = typename base_t::state_type;
+			return (static_cast<base_state const&>(rhs) - static_cast<base_state const&>(lhs))
+				+ std::ptrdiff_t(rhs.m_refs - lhs.m_refs);
+		}
+
+	private:
+		friend class iovec_buffer;
+		constexpr state_type(typename base_t::state_type const& st, uint8_t* seg_start, std::size_t count, std::size_t refs) noexcept
+			: base_t::state_type{st}, m_seg_start{seg_start}, m_count{count}, m_refs{refs} {}
+
+		uint8_t*     m_seg_start{nullptr};
+		std::size_t  m_count{0};
+		std::size_t  m_refs{0};
+	};
+
+	template <class... ARGS>
+	constexpr void reset(ARGS&&... args) noexcept
+	{
+		base_t::reset(std::forward<ARGS>(args)...);
+		m_seg_start = this->begin();
+		m_count = 0;
+		m_refs = 0;
+	}
+
+	constexpr state_type get_state() const noexcept
+	{
+		return state_type{base_t::get_state(), m_seg_start, m_count, m_refs};
+	}
+
+	//segments referenced after the state are dropped (kept in place to return forward)
+	constexpr void set_state(state_type const& st) noexcept
+	{
+		base_t::set_state(st);
+		m_seg_start = st.m_seg_start;
+		m_count = st.m_count;
+		m_refs = st.m_refs;
+	}
+
+	constexpr std::size_t threshold() const noexcept        { return m_threshold; }
+	constexpr void threshold(std::size_t v) noexcept        { m_threshold = v; }
+
+	/**
+	 * References the data in place if it's large enough
+	 * @return false if the data should be copied into the buffer
+	 */
+	constexpr bool refer(void const* data, std::size_t size) noexcept
+	{
+		//one segment is always reserved for the scratch tail
+		if (size < m_threshold || m_count + 2 >= MAX_SEGMENTS) { return false; }
+		if (this->begin() != m_seg_start)
+		{
+			m_iov[m_count++] = ::iovec{m_seg_start, std::size_t(this->begin() - m_seg_start)};
+		}
+		m_iov[m_count++] = ::iovec{const_cast<void*>(data), size};
+		m_refs += size;
+		m_seg_start = this->begin();
+		CODEC_TRACE("refer %zu octets as segment #%zu", size, m_count);
+		return true;
+	}
+
+	//total number of octets encoded including referenced
+	constexpr std::size_t total_size() const noexcept       { return this->get_offset() + m_refs; }
+
+	//chain of segments for writev/sendmsg
+	std::span<::iovec const> chain() noexcept
+	{
+		std::size_t num = m_count;
+		if (this->begin() != m_seg_start)
+		{
+			m_iov[num++] = ::iovec{m_seg_start, std::size_t(this->begin() - m_seg_start)};
+		}
+		return {m_iov, num};
+	}
+
+private:
+	uint8_t*     m_seg_start{nullptr};
+	std::size_t  m_count{0};
+	std::size_t  m_refs{0};
+	std::size_t  m_threshold{DEFAULT_THRESHOLD};
+	::iovec      m_iov[MAX_SEGMENTS]{};
+};
+
+}	//end: namespace med
@@ -0,0 +1,275 @@
+/**
+@file
+set IE container decoded lazily on access
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "set.hpp"
+#include "count.hpp"
+#include "sl/ie_skip.hpp"
+
+namespace med {
+
+//location of IE in the encoded set
+struct lazy_entry
+{
+	std::size_t tag;    //decoded tag of IE
+	uint32_t    offset; //of the tag from the start of set
+	uint32_t    size;   //of IE including its tag
+	uint16_t    index;  //of IE in the set
+};
+
+namespace sl {
+
+struct lazy_scan
+{
+	template <class IE, class TO, class DECODER, class HEADER, class STATE>
+	static bool check(TO& to, DECODER& decoder, HEADER const& header, STATE const&)
+	{
+		return set_dec::check<IE>(to, decoder, header);
+	}
+
+	template <class IE, class TO, class DECODER, class HEADER, class STATE>
+	static constexpr void apply(TO& to, DECODER& decoder, HEADER const& header, STATE const& start)
+	{
+		to.template scan<IE>(decoder, header, start);
+	}
+
+	template <class TO, class DECODER, class HEADER, class STATE>
+	static constexpr void apply(TO&, DECODER& decoder, HEADER const& header, STATE const&)
+	{
+		MED_RETURN_ERROR(decoder, unknown_tag, name<TO>(), get_tag(header))
+	}
+};
+
+struct lazy_check
+{
+	template <class IE, class TO, class DECODER>
+	static constexpr void apply(TO const& to, DECODER& decoder)
+	{
+		to.template check_ie<IE>(decoder);
+	}
+
+	template <class TO, class DECODER>
+	static constexpr void apply(TO const&, DECODER&) {}
+};
+
+struct lazy_load
+{
+	template <class IE, class TO, class DECODER>
+	static constexpr void apply(TO& to, DECODER& decoder)
+	{
+		to.template load<IE>(decoder);
+	}
+
+	template <class TO, class DECODER>
+	static constexpr void apply(TO&, DECODER&) {}
+};
+
+}	//end: namespace sl
+
+/**
+ * Set decoded lazily on access of its IEs
+ * @details The decoding only scans the headers of IEs recording their location
+ * in the index while the value of IE is decoded on 1st get<FIELD>(decoder).
+ * IEs which can't be skipped w/o decoding (e.g. w/o length) are decoded at once.
+ * The arity of IEs is validated by explicit check(decoder).
+ * NOTE: the decoded octets are referenced by the index thus have to outlive it
+ * and the context of decoder is reset to IE being decoded on access.
+ * @tparam SET the set with plain header (tag)
+ * @tparam MAX_IES max number of IEs in the index
+ */
+template <class SET, std::size_t MAX_IES = 64>
+class lazy_set : public SET
+{
+public:
+	using ies_types = typename SET::ies_types;
+	static_assert(SET::plain_header, "COMPOUND HEADER IS NOT SUPPORTED");
+	static_assert(MAX_IES <= std::numeric_limits<uint16_t>::max());
+
+	using SET::get;
+
+	template <class DECODER, class... DEPS>
+	void decode(DECODER& decoder, DEPS&...)
+	{
+		static_assert(std::is_void_v<meta::unique_t<tag_getter<DECODER>, ies_types>>
+			, "SEE ERROR ON INCOMPLETE TYPE/UNDEFINED TEMPLATE HOLDING IEs WITH CLASHED TAGS");
+		using IE = meta::list_first_t<ies_types>; //use 1st IE since all have similar tag
+		using mi = meta::produce_info_t<DECODER, IE>;
+		using tag_t = get_info_t<meta::list_first_t<mi>>;
+
+		clear();
+		auto const start = decoder(GET_STATE{});
+		m_data = start;
+		while (decoder(PUSH_STATE{}, *this))
+		{
+			auto const ie_start = decoder(GET_STATE{});
+			value<std::size_t> header;
+			header.set_encoded(sl::decode_tag<tag_t>(decoder));
+			CODEC_TRACE("tag=%#zX lazy %s", std::size_t(get_tag(header)), name<SET>());
+			sl::for_tag<ies_types, DECODER>(get_tag(header), sl::lazy_scan{}, *this, decoder, header, ie_start);
+		}
+	}
+
+	//decodes the field on 1st access
+	template <class FIELD, class DECODER>
+	decltype(auto) get(DECODER& decoder)
+	{
+		using IE = meta::find_t<ies_types, sl::field_at<FIELD>>;
+		static_assert(!std::is_void<IE>(), "NO SUCH FIELD");
+		load<IE>(decoder);
+		return SET::template get<FIELD>();
+	}
+
+	//validates arity of IEs (decodes conditional ones if any)
+	template <class DECODER>
+	void check(DECODER& decoder)
+	{
+		if constexpr (has_conditions()) { load_all(decoder); }
+		meta::foreach<ies_types>(sl::lazy_check{}, *this, decoder);
+	}
+
+	//decodes all IEs not decoded yet
+	template <class DECODER>
+	void load_all(DECODER& decoder)   { meta::foreach<ies_types>(sl::lazy_load{}, *this, decoder); }
+
+	void clear()
+	{
+		SET::clear();
+		m_data = nullptr;
+		m_size = 0;
+		m_count = {};
+		m_loaded = {};
+	}
+
+	std::span<lazy_entry const> index() const noexcept   { return {m_index.data(), m_size}; }
+
+#ifndef UNIT_TEST
+private:
+#endif
+	friend struct sl::lazy_scan;
+	friend struct sl::lazy_check;
+	friend struct sl::lazy_load;
+
+	static constexpr std::size_t num_ies = meta::list_size_v<ies_types>;
+
+	static constexpr bool has_conditions()
+	{
+		return []<class... IEs>(meta::typelist<IEs...>*) { return (AHasCondition<IEs> || ...); }
+			(static_cast<ies_types*>(nullptr));
+	}
+
+	template <class IE, class DECODER, class HEADER, class STATE>
+	void scan(DECODER& decoder, HEADER const& header, STATE const& ie_start)
+	{
+		constexpr auto kind = sl::get_skip_kind<IE, DECODER>();
+		if constexpr (kind == sl::skip_kind::EAGER)
+		{
+			sl::set_dec::apply<IE>(this->m_ies, decoder, header);
+		}
+		else
+		{
+			constexpr std::size_t idx = meta::list_index_of_v<IE, ies_types>;
+			if (m_count[idx] >= sl::field_arity<IE>())
+			{
+				MED_RETURN_ERROR(decoder, extra_ie, name<IE>(), sl::field_arity<IE>(), m_count[idx] + 1)
+			}
+			if (m_size >= MAX_IES)
+			{
+				MED_RETURN_ERROR(decoder, out_of_memory, name<SET>(), MAX_IES * sizeof(lazy_entry))
+			}
+
+			sl::skip_value<IE, kind>(decoder, ie_start);
+			if (has_failed(decoder)) { return; }
+
+			auto const end = decoder(GET_STATE{});
+			m_index[m_size++] = lazy_entry{
+				get_tag(header), uint32_t(ie_start - m_data), uint32_t(end - ie_start), uint16_t(idx)};
+			++m_count[idx];
+			CODEC_TRACE("lazy[%s] @%u %u octets", name<IE>(), m_index[m_size-1].offset, m_index[m_size-1].size);
+		}
+	}
+
+	template <class IE, class DECODER>
+	void load(DECODER& decoder)
+	{
+		constexpr auto kind = sl::get_skip_kind<IE, DECODER>();
+		constexpr std::size_t idx = meta::list_index_of_v<IE, ies_types>;
+		if constexpr (kind != sl::skip_kind::EAGER)
+		{
+			if (m_loaded[idx]) { return; }
+			if (!m_count[idx]) { m_loaded[idx] = true; return; }
+
+			using mi = meta::produce_info_t<DECODER, IE>;
+			using tag_t = get_info_t<meta::list_first_t<mi>>;
+			//IE with non-fixed tag decodes its tag itself
+			using ctx = type_context<IE_SET, conditional_t<APredefinedValue<tag_t>, mi, meta::list_rest_t<mi>>>;
+
+			IE& ie = this->m_ies;
+			this->m_ies.template mark<IE>();
+			ie.clear(); //of previous attempt failed
+			for (auto const& e : index())
+			{
+				if (e.index != idx) { continue; }
+				decoder.get_context().reset(m_data + e.offset, e.size);
+				//as an outer length to restore the end after explicit length of IE
+				auto const end = decoder(PUSH_SIZE{e.size});
+				if constexpr (AMultiField<IE>)
+				{
+					auto* field = ie.push_back(decoder);
+					if (!field) { return; }
+					sl::ie_decode<ctx>(decoder, *field);
+				}
+				else
+				{
+					sl::ie_decode<ctx>(decoder, ie);
+				}
+				if (has_failed(decoder)) { return; }
+			}
+			//failed one is decoded again on next access
+			m_loaded[idx] = true;
+		}
+	}
+
+	template <class IE, class DECODER>
+	void check_ie(DECODER& decoder) const
+	{
+		constexpr auto kind = sl::get_skip_kind<IE, DECODER>();
+		constexpr std::size_t idx = meta::list_index_of_v<IE, ies_types>;
+		if constexpr (kind != sl::skip_kind::EAGER && !AHasCondition<IE>)
+		{
+			if (!m_loaded[idx])
+			{
+				IE const& ie = this->m_ies;
+				if constexpr (AMultiField<IE>)
+				{
+					check_arity(decoder, ie, m_count[idx]);
+				}
+				else if (not (AOptional<IE> || m_count[idx]))
+				{
+					MED_RETURN_ERROR(decoder, missing_ie, name<IE>(), 1, 0)
+				}
+				return;
+			}
+		}
+		sl::set_check::apply<IE>(this->m_ies, decoder);
+	}
+
+	uint8_t const*                    m_data{nullptr};
+	std::size_t                       m_size{0};
+	std::array<lazy_entry, MAX_IES>   m_index;
+	std::array<uint16_t, num_ies>     m_count{};
+	std::array<bool, num_ies>         m_loaded{};
+};
+
+}	//end: namespace med
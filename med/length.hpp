@@ -130,8 +130,8 @@ constexpr std::size_t field_length(IE const& ie, ENCODER& encoder) noexcept
 }
 
 
-template <AField FIELD>
-constexpr void length_to_value(FIELD& field, std::size_t len)
+template <class FUNC, AField FIELD>
+constexpr void length_to_value(FUNC& func, FIELD& field, std::size_t len)
 {
 	//set the length IE with the value
 	if constexpr (AHasSetLength<FIELD>)
@@ -140,7 +140,7 @@ constexpr void length_to_value(FIELD& field, std::size_t len)
 		{
 			if (not field.set_length(len))
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<FIELD>(), len)
+				MED_RETURN_ERROR(func, invalid_value, name<FIELD>(), len)
 			}
 		}
 		else
@@ -152,7 +152,7 @@ constexpr void length_to_value(FIELD& field, std::size_t len)
 	{
 		if (not field.set_encoded(len))
 		{
-			MED_THROW_EXCEPTION(invalid_value, name<FIELD>(), len)
+			MED_RETURN_ERROR(func, invalid_value, name<FIELD>(), len)
 		}
 	}
 	else
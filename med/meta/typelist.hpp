@@ -134,6 +134,28 @@ struct append<L1<T1...>, L2<T2...>, Ts...> : append<L1<T1..., T2...>, Ts...> {};
 template <class... L> using append_t = typename append<L...>::type;
 
 
+/* --- reverse order of types in list --- */
+template <class L> struct list_reverse;
+template <template<class...> class L> struct list_reverse<L<>> { using type = L<>; };
+template <template<class...> class L, class T1, class... T>
+struct list_reverse<L<T1, T...>>
+{
+	using type = list_push_back_t<typename list_reverse<L<T...>>::type, T1>;
+};
+template <class L> using list_reverse_t = typename list_reverse<L>::type;
+
+
+/* --- first N types of list --- */
+template <class L, std::size_t N> struct list_head;
+template <template<class...> class L, class... T> struct list_head<L<T...>, 0> { using type = L<>; };
+template <template<class...> class L, class T1, class... T, std::size_t N> requires (N > 0)
+struct list_head<L<T1, T...>, N>
+{
+	using type = list_push_front_t<typename list_head<L<T...>, N - 1>::type, T1>;
+};
+template <class L, std::size_t N> using list_head_t = typename list_head<L, N>::type;
+
+
 /* --- remove from lists of types --- */
 template <class L, class P>
 struct remove_if {};
@@ -15,12 +15,13 @@ Distributed under the MIT License
 #include "name.hpp"
 #include "ie_type.hpp"
 #include "sl/octet_info.hpp"
+#include "sl/fixed_layout.hpp"
 #include "padding.hpp"
 
 namespace med {
 
-template <class DEC_CTX>
-struct octet_decoder : sl::octet_info
+template <class DEC_CTX, class ERR_POLICY = default_error_policy>
+struct octet_decoder : sl::octet_info, error_handler<octet_decoder<DEC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	using state_type = typename DEC_CTX::buffer_type::state_type;
 	using size_state = typename DEC_CTX::buffer_type::size_state;
@@ -28,20 +29,20 @@ struct octet_decoder : sl::octet_info
 	template <class... PA>
 	using padder_type = octet_padder<PA...>;
 
-	explicit octet_decoder(DEC_CTX& c) : m_ctx{c} { }
+	explicit octet_decoder(DEC_CTX& c, ERR_POLICY = {}) : m_ctx{c} { }
 	DEC_CTX& get_context() noexcept             { return m_ctx; }
 	allocator_type& get_allocator()             { return get_context().get_allocator(); }
 
 	//state
-	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit); }
+	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit, *this); }
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)     { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                 { get_context().buffer().pop_state(); }
 	auto operator() (GET_STATE)                 { return get_context().buffer().get_state(); }
 	template <class IE>
 	bool operator() (CHECK_STATE, IE const&)    { return !get_context().buffer().empty(); }
-	void operator() (ADVANCE_STATE ss)          { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta); }
-	void operator() (ADD_PADDING pad)           { get_context().buffer().template advance<ADD_PADDING>(pad.pad_size); }
+	void operator() (ADVANCE_STATE ss)          { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta, *this); }
+	void operator() (ADD_PADDING pad)           { get_context().buffer().template advance<ADD_PADDING>(pad.pad_size, *this); }
 
 	//IE_TAG
 	template <class IE> [[nodiscard]] auto operator() (IE&, IE_TAG)
@@ -68,7 +69,8 @@ struct octet_decoder : sl::octet_info
 		using value_t = typename IE::value_type;
 		constexpr auto NUM_BITS = IE::traits::bits + IE::traits::offset;
 		constexpr auto NUM_BYTES = bits_to_bytes(NUM_BITS);
-		uint8_t const* pval = get_context().buffer().template advance_bits<IE, NUM_BITS>();
+		uint8_t const* pval = get_context().buffer().template advance_bits<IE, NUM_BITS>(*this);
+		if (!pval) { return; }
 
 		auto const val = [](uint8_t const* in)
 		{
@@ -95,7 +97,7 @@ struct octet_decoder : sl::octet_info
 		{
 			if (not ie.set_encoded(val))
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<IE>(), val, get_context().buffer())
+				MED_RETURN_ERROR(*this, invalid_value, name<IE>(), val, get_context().buffer())
 			}
 		}
 		else
@@ -105,18 +107,44 @@ struct octet_decoder : sl::octet_info
 		CODEC_TRACE("VAL=%zXh [%s]: %s", std::size_t(val), name<IE>(), get_context().buffer().toString());
 	}
 
+	//fixed layout of values: single bounds check and loads fused in words
+	//NOTE: returns false to decode field by field reporting the error if any
+	template <class IE_LIST, class IES> bool operator() (sl::FIXED_LAYOUT<IE_LIST>, IES& ies)
+	{
+		using layout = sl::fixed_layout<IE_LIST>;
+		auto& buf = get_context().buffer();
+		if constexpr (requires { buf.template view<IES>(0, *this); }) //non-contiguous input
+		{
+			return false;
+		}
+		else
+		{
+			if (buf.size() < layout::size || not layout::get(buf.begin(), ies)) { return false; }
+			buf.offset(layout::size);
+			CODEC_TRACE("FIXED[%s] %zu octets: %s", name<IE_LIST>(), layout::size, buf.toString());
+			return true;
+		}
+	}
+
 	//IE_OCTET_STRING
 	template <class IE> void operator() (IE& ie, IE_OCTET_STRING)
 	{
 		CODEC_TRACE("STR[%s] <-(%zu bytes): %s", name<IE>(), get_context().buffer().size(), get_context().buffer().toString());
-		if (ie.set_encoded(get_context().buffer().size(), get_context().buffer().begin()))
+		auto& buf = get_context().buffer();
+		auto const* data = buf.begin();
+		if constexpr (requires { buf.template view<IE>(0, *this); }) //non-contiguous input
+		{
+			data = buf.template view<IE>(std::min(buf.size(), std::size_t(IE::traits::max_octets)), *this);
+			if (!data) { return; }
+		}
+		if (ie.set_encoded(buf.size(), data))
 		{
 			CODEC_TRACE("STR[%s] -> len = %zu bytes", name<IE>(), std::size_t(ie.size()));
-			get_context().buffer().template advance<IE>(ie.size());
+			get_context().buffer().template advance<IE>(ie.size(), *this);
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(invalid_value, name<IE>(), ie.size(), get_context().buffer())
+			MED_RETURN_ERROR(*this, invalid_value, name<IE>(), ie.size(), get_context().buffer())
 		}
 	}
 
@@ -9,26 +9,31 @@ Distributed under the MIT License
 
 #pragma once
 
+#include <cstring>
+
 #include "bytes.hpp"
 #include "name.hpp"
 #include "state.hpp"
 #include "length.hpp"
 #include "octet_string.hpp"
 #include "sl/octet_info.hpp"
+#include "sl/fixed_layout.hpp"
 #include "padding.hpp"
 
 namespace med {
 
-template <class ENC_CTX>
-struct octet_encoder : sl::octet_info
+template <class ENC_CTX, class ERR_POLICY = default_error_policy>
+struct octet_encoder : sl::octet_info, error_handler<octet_encoder<ENC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	//required for length_encoder
 	using state_type = typename ENC_CTX::buffer_type::state_type;
 	template <class... PA>
 	using padder_type = octet_padder<PA...>;
 	using allocator_type = typename ENC_CTX::allocator_type;
+	//length is reserved and written after its IE is encoded (single pass)
+	static constexpr bool backpatch_length = true;
 
-	explicit octet_encoder(ENC_CTX& ctx_) : m_ctx{ ctx_ } { }
+	explicit octet_encoder(ENC_CTX& ctx_, ERR_POLICY = {}) : m_ctx{ ctx_ } { }
 	ENC_CTX& get_context() noexcept                   { return m_ctx; }
 	allocator_type& get_allocator()                   { return get_context().get_allocator(); }
 
@@ -47,21 +52,34 @@ struct octet_encoder : sl::octet_info
 			}
 			else
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<IE>(), len, get_context().buffer())
+				MED_RETURN_ERROR(*this, invalid_value, name<IE>(), len, get_context().buffer())
 			}
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0, get_context().buffer())
+			MED_RETURN_ERROR(*this, missing_ie, name<IE>(), 1, 0, get_context().buffer())
 		}
 	}
 
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)           { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                       { get_context().buffer().pop_state(); }
-	void operator() (ADVANCE_STATE ss)                { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta); }
-	void operator() (ADD_PADDING pad)                 { get_context().buffer().template fill<ADD_PADDING>(pad.pad_size, pad.filler); }
-	void operator() (SNAPSHOT ss)                     { get_context().put_snapshot(ss); }
+	void operator() (ADVANCE_STATE ss)                { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta, *this); }
+	void operator() (ADD_PADDING pad)                 { get_context().buffer().template fill<ADD_PADDING>(pad.pad_size, pad.filler, *this); }
+	void operator() (COPY_OCTETS co)
+	{
+		uint8_t* out = get_context().buffer().template advance<COPY_OCTETS>(int(co.size), *this);
+		if (!out) { return; }
+		std::memcpy(out, co.data, co.size);
+		CODEC_TRACE("COPY %zu octets: %s", co.size, get_context().buffer().toString());
+	}
+	void operator() (SNAPSHOT ss)
+	{
+		if (not get_context().put_snapshot(ss))
+		{
+			MED_RETURN_ERROR(*this, out_of_memory, ss.id, ss.size, get_context().buffer())
+		}
+	}
 
 	template <class IE> constexpr std::size_t operator() (GET_LENGTH, IE const& ie) const noexcept
 	{
@@ -100,7 +118,8 @@ struct octet_encoder : sl::octet_info
 	{
 		constexpr auto NUM_BITS = IE::traits::bits + IE::traits::offset;
 		constexpr auto NUM_BYTES = bits_to_bytes(NUM_BITS);
-		uint8_t* out = get_context().buffer().template advance_bits<IE, NUM_BITS>();
+		uint8_t* out = get_context().buffer().template advance_bits<IE, NUM_BITS>(*this);
+		if (!out) { return; }
 		if constexpr (IE::traits::offset == 0 && (IE::traits::bits % 8) == 0)
 		{
 			put_bytes<NUM_BYTES>(ie.get_encoded(), out);
@@ -118,10 +137,33 @@ struct octet_encoder : sl::octet_info
 		CODEC_TRACE("V=%zXh %zu@%zu bits[%s]: %s", std::size_t(ie.get_encoded()), IE::traits::bits, IE::traits::offset, name<IE>(), get_context().buffer().toString());
 	}
 
+	//fixed layout of values: single bounds check and stores fused in words
+	//NOTE: returns false to encode field by field reporting the error if any
+	template <class IE_LIST, class IES> bool operator() (sl::FIXED_LAYOUT<IE_LIST>, IES const& ies)
+	{
+		using layout = sl::fixed_layout<IE_LIST>;
+		auto& buf = get_context().buffer();
+		if (buf.size() < layout::size || not layout::is_set(ies)) { return false; }
+		layout::put(buf.begin(), ies);
+		buf.offset(layout::size);
+		CODEC_TRACE("FIXED[%s] %zu octets: %s", name<IE_LIST>(), layout::size, buf.toString());
+		return true;
+	}
+
 	//IE_OCTET_STRING
 	template <class IE> void operator() (IE const& ie, IE_OCTET_STRING)
 	{
-		uint8_t* out = get_context().buffer().template advance<IE>(ie.size());
+		//large strings are referenced in place by scatter-gather buffer
+		if constexpr (requires { get_context().buffer().refer(ie.data(), ie.size()); })
+		{
+			if (get_context().buffer().refer(ie.data(), ie.size()))
+			{
+				CODEC_TRACE("STR[%s] %zu octets referenced: %s", name<IE>(), ie.size(), get_context().buffer().toString());
+				return;
+			}
+		}
+		uint8_t* out = get_context().buffer().template advance<IE>(ie.size(), *this);
+		if (!out) { return; }
 		octets<IE::traits::min_octets, IE::traits::max_octets>::copy(out, ie.data(), ie.size());
 		CODEC_TRACE("STR[%s] %zu octets: %s", name<IE>(), ie.size(), get_context().buffer().toString());
 	}
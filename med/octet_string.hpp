@@ -13,6 +13,7 @@ Distributed under the MIT License
 #include <string_view>
 
 #include "field.hpp"
+#include "offset_ptr.hpp"
 #include "debug.hpp"
 #include "value_traits.hpp"
 
@@ -55,10 +56,25 @@ private:
 	}
 };
 
+namespace detail {
+
+//duplicates external octets when the copy context supports it (deep copy)
+inline uint8_t const* duplicate_octets(uint8_t const* data, std::size_t)  { return data; }
+template <class CTX, class... ARGS>
+uint8_t const* duplicate_octets(uint8_t const* data, std::size_t size, CTX&& ctx, ARGS&&...)
+{
+	if constexpr (requires { ctx.duplicate(data, size); }) { return ctx.duplicate(data, size); }
+	else { return data; }
+}
+
+} //end: namespace detail
+
 //variable length octets with external storage
 class octets_var_extern
 {
 public:
+	static constexpr bool external = true;
+
 	bool is_set() const                         { return m_data != nullptr; }
 
 	std::size_t size() const                    { return m_size; }
@@ -68,12 +84,12 @@ public:
 	void assign(void const* b_, void const* e_)
 	{
 		m_data = static_cast<uint8_t const*>(b_);
-		m_size = num_octs_t(static_cast<uint8_t const*>(e_) - m_data);
+		m_size = num_octs_t(static_cast<uint8_t const*>(e_) - static_cast<uint8_t const*>(b_));
 	}
 
 private:
-	uint8_t const* m_data {nullptr};
-	num_octs_t     m_size {0}; //not using size_t to reduce layout size
+	offset_ptr<uint8_t const> m_data;
+	num_octs_t                m_size {0}; //not using size_t to reduce layout size
 };
 
 //variable length octets with internal storage
@@ -111,6 +127,8 @@ template <std::size_t LEN>
 class octets_fix_extern
 {
 public:
+	static constexpr bool external = true;
+
 	bool is_set() const                         { return nullptr != data(); }
 
 	constexpr std::size_t size() const          { return LEN; }
@@ -120,7 +138,7 @@ public:
 	void assign(uint8_t const* p, void const*)  { m_data = p; }
 
 private:
-	uint8_t const* m_data {nullptr};
+	offset_ptr<uint8_t const> m_data;
 };
 
 //fixed length octets with internal storage
@@ -172,10 +190,21 @@ struct octet_string_impl : IE<IE_OCTET_STRING>
 	void clear()                                { m_value.clear(); }
 
 	template <class... ARGS>
-	void copy(base_t const& from, ARGS&&...)
+	void copy(base_t const& from, ARGS&&... args)
 	{
 		clear();
-		m_value.assign(from.begin(), from.end());
+		if constexpr (requires { value_type::external; })
+		{
+			if (from.is_set())
+			{
+				auto const* p = detail::duplicate_octets(from.data(), from.size(), std::forward<ARGS>(args)...);
+				m_value.assign(p, p + from.size());
+			}
+		}
+		else
+		{
+			m_value.assign(from.begin(), from.end());
+		}
 	}
 
 	template <class T = VALUE> decltype(std::declval<T>().resize(0))
@@ -0,0 +1,55 @@
+/**
+@file
+pointer stored as offset from itself to keep the object relocatable
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace med {
+
+/**
+ * Pointer relative to its own location
+ * @details The regular copy re-targets to the same pointee thus the object
+ * holding the pointer isn't trivially copyable and must not be copied by
+ * memcpy on its own. Only the whole memory region holding the object along
+ * with the pointee (e.g. arena with message, its input and allocations) is
+ * relocated as raw memory (memcpy, shared memory) keeping relative location.
+ * The object in relocated region is then accessed via std::launder.
+ */
+template <class T>
+class offset_ptr
+{
+public:
+	offset_ptr() noexcept = default;
+	offset_ptr(T* p) noexcept                           { set(p); }
+	offset_ptr(offset_ptr const& rhs) noexcept          { set(rhs.get()); }
+	offset_ptr& operator=(offset_ptr const& rhs) noexcept { set(rhs.get()); return *this; }
+	offset_ptr& operator=(T* p) noexcept                { set(p); return *this; }
+
+	T* get() const noexcept
+	{
+		return m_offset != null ? reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(this) + m_offset) : nullptr;
+	}
+	operator T*() const noexcept                        { return get(); }
+	T* operator->() const noexcept                      { return get(); }
+
+private:
+	//offset of 1 is null since it points inside the pointer itself
+	//NOTE: zero offset is valid as the pointer may be used as non-null sentinel to itself
+	static constexpr std::uintptr_t null = 1;
+
+	void set(T* p) noexcept
+	{
+		m_offset = p ? reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(this) : null;
+	}
+
+	std::uintptr_t m_offset {null};
+};
+
+} //end: namespace med
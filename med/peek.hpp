@@ -0,0 +1,286 @@
+/**
+@file
+extraction of single IE from encoded message w/o decoding the message
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "decode.hpp"
+#include "set.hpp"
+#include "choice.hpp"
+#include "sequence.hpp"
+#include "sl/ie_skip.hpp"
+
+namespace med {
+
+namespace sl {
+
+template <class TYPE_CTX, class IE, class... PATH>
+constexpr void peek_ie(auto& decoder, auto& out);
+
+//extracts the field from decoded container (1st one of multi-field)
+template <class FIELD, class OUT>
+constexpr void peek_field(auto const& cont, OUT& out)
+{
+	decltype(auto) field = cont.template get<FIELD>();
+	using field_t = std::remove_cvref_t<decltype(field)>;
+	if constexpr (std::is_pointer_v<field_t>)
+	{
+		if (field) { out.emplace(*field); }
+	}
+	else if constexpr (AMultiField<field_t>)
+	{
+		if (auto const* p = field.first()) { out.emplace(*p); }
+	}
+	else
+	{
+		if (field.is_set()) { out.emplace(field); }
+	}
+}
+
+//sequence is decoded up to the IE of path
+template <class SEQ, class FIELD, class... PATH>
+constexpr void peek_sequence(auto& decoder, auto& out)
+{
+	using ies_types = typename SEQ::ies_types;
+	using IE = meta::find_t<ies_types, field_at<FIELD>>;
+	static_assert(!std::is_void_v<IE>, "NO SUCH FIELD IN SEQUENCE");
+	constexpr auto idx = meta::list_index_of_v<IE, ies_types>;
+
+	SEQ seq;
+	if constexpr (sizeof...(PATH) == 0)
+	{
+		seq.template decode<meta::list_head_t<ies_types, idx + 1>>(decoder);
+		if (has_failed(decoder)) { return; }
+		peek_field<FIELD>(seq, out);
+	}
+	else
+	{
+		seq.template decode<meta::list_head_t<ies_types, idx>>(decoder);
+		if (has_failed(decoder)) { return; }
+		using mi = meta::produce_info_t<decltype(decoder), IE>;
+		peek_ie<type_context<IE_SEQUENCE, mi>, FIELD, PATH...>(decoder, out);
+	}
+}
+
+template <class TARGET, class... PATH>
+struct peek_set
+{
+	template <class IE, class DECODER, class HEADER, class STATE, class OUT>
+	static bool check(DECODER& decoder, HEADER const& header, STATE const&, OUT&, bool&)
+	{
+		return set_dec::check<IE>(decoder, decoder, header);
+	}
+
+	template <class IE, class DECODER, class HEADER, class STATE, class OUT>
+	static constexpr void apply(DECODER& decoder, HEADER const&, STATE const& ie_start, OUT& out, bool& found)
+	{
+		if constexpr (std::is_same_v<IE, TARGET>)
+		{
+			using mi = meta::produce_info_t<DECODER, IE>;
+			//IE with non-fixed tag decodes its tag itself
+			using tag_t = get_info_t<meta::list_first_t<mi>>;
+			if constexpr (!APredefinedValue<tag_t>) { decoder(POP_STATE{}); }
+			found = true;
+			peek_ie<type_context<IE_SET, meta::list_rest_t<mi>>, get_field_type_t<IE>, PATH...>(decoder, out);
+		}
+		else
+		{
+			skip_ie<IE>(decoder, ie_start);
+		}
+	}
+
+	template <class DECODER, class HEADER, class STATE, class OUT>
+	static constexpr void apply(DECODER& decoder, HEADER const& header, STATE const&, OUT&, bool&)
+	{
+		MED_RETURN_ERROR(decoder, unknown_tag, __FUNCTION__, get_tag(header))
+	}
+};
+
+//set is scanned till the IE of path skipping others
+template <class SET, class FIELD, class... PATH>
+constexpr void peek_set_ie(auto& decoder, auto& out)
+{
+	static_assert(SET::plain_header, "COMPOUND HEADER IS NOT SUPPORTED");
+	using DECODER = std::remove_reference_t<decltype(decoder)>;
+	using ies_types = typename SET::ies_types;
+	using TARGET = meta::find_t<ies_types, field_at<FIELD>>;
+	static_assert(!std::is_void_v<TARGET>, "NO SUCH FIELD IN SET");
+	using mi = meta::produce_info_t<DECODER, meta::list_first_t<ies_types>>;
+	using tag_t = get_info_t<meta::list_first_t<mi>>;
+
+	value<std::size_t> header;
+	bool found = false;
+	while (!found && decoder(PUSH_STATE{}, header))
+	{
+		auto const ie_start = decoder(GET_STATE{});
+		header.set_encoded(decode_tag<tag_t>(decoder));
+		if (has_failed(decoder)) { return; }
+		CODEC_TRACE("peek tag=%#zX in %s", std::size_t(get_tag(header)), name<SET>());
+		for_tag<ies_types, DECODER>(get_tag(header), peek_set<TARGET, PATH...>{}, decoder, header, ie_start, out, found);
+	}
+}
+
+template <class TARGET, class... PATH>
+struct peek_choice
+{
+	template <class IE, class DECODER, class HEADER, class OUT>
+	static constexpr bool check(DECODER&, HEADER const& header, OUT&)
+	{
+		using mi = meta::produce_info_t<DECODER, IE>;
+		using tag_t = get_info_t<meta::list_first_t<mi>>;
+		return tag_t::match(get_tag(header));
+	}
+
+	template <class IE, class DECODER, class HEADER, class OUT>
+	static constexpr void apply(DECODER& decoder, HEADER const&, OUT& out)
+	{
+		if constexpr (std::is_same_v<IE, TARGET>)
+		{
+			using mi = meta::produce_info_t<DECODER, IE>;
+			if constexpr (AContainer<IE>)
+			{
+				static_assert(!std::is_same_v<get_info_t<meta::list_first_t<mi>>
+						, get_field_type_t<meta::list_first_t<typename IE::ies_types>>>
+					, "CHOICE WITH EXPLICIT TAG IS NOT SUPPORTED");
+			}
+			peek_ie<type_context<IE_CHOICE, meta::list_rest_t<mi>>, get_field_type_t<IE>, PATH...>(decoder, out);
+		}
+		//else: other case is selected
+	}
+
+	template <class DECODER, class HEADER, class OUT>
+	static constexpr void apply(DECODER& decoder, HEADER const& header, OUT&)
+	{
+		MED_RETURN_ERROR(decoder, unknown_tag, __FUNCTION__, get_tag(header))
+	}
+};
+
+//choice is followed only if the case of path is selected
+template <class CHOICE, class FIELD, class... PATH>
+constexpr void peek_choice_ie(auto& decoder, auto& out)
+{
+	using DECODER = std::remove_reference_t<decltype(decoder)>;
+	using ies_types = typename CHOICE::ies_types;
+	if constexpr (CHOICE::plain_header)
+	{
+		using TARGET = meta::find_t<ies_types, field_at<FIELD>>;
+		static_assert(!std::is_void_v<TARGET>, "NO SUCH CASE IN CHOICE");
+		using mi = meta::produce_info_t<DECODER, meta::list_first_t<ies_types>>;
+		using tag_t = get_info_t<meta::list_first_t<mi>>;
+		as_writable_t<tag_t> tag;
+		tag.set_encoded(decode_tag<tag_t>(decoder));
+		if (has_failed(decoder)) { return; }
+		for_tag<ies_types, DECODER>(get_tag(tag), peek_choice<TARGET, PATH...>{}, decoder, tag, out);
+	}
+	else
+	{
+		using header_type = typename CHOICE::header_type;
+		if constexpr (std::is_same_v<FIELD, header_type>)
+		{
+			peek_ie<type_context<IE_CHOICE, meta::produce_info_t<DECODER, header_type>>, header_type, PATH...>(decoder, out);
+		}
+		else
+		{
+			using TARGET = meta::find_t<ies_types, field_at<FIELD>>;
+			static_assert(!std::is_void_v<TARGET>, "NO SUCH CASE IN CHOICE");
+			header_type header;
+			med::decode(decoder, header);
+			if (has_failed(decoder)) { return; }
+			for_tag<ies_types, DECODER>(get_tag(header), peek_choice<TARGET, PATH...>{}, decoder, header, out);
+		}
+	}
+}
+
+//IE with the meta-information to be decoded
+template <class TYPE_CTX, class IE, class... PATH>
+constexpr void peek_ie(auto& decoder, auto& out)
+{
+	using META_INFO = typename TYPE_CTX::meta_info_type;
+	if constexpr (sizeof...(PATH) == 0) //IE to peek
+	{
+		auto& ie = out.emplace();
+		ie_decode<TYPE_CTX>(decoder, ie);
+		if (has_failed(decoder)) { out.reset(); }
+	}
+	else if constexpr (not meta::list_is_empty_v<META_INFO>)
+	{
+		using mi = meta::list_first_t<META_INFO>;
+		using info_t = get_info_t<mi>;
+		using ctx = type_context<typename TYPE_CTX::ie_type, meta::list_rest_t<META_INFO>>;
+		if constexpr (mi::kind == mik::LEN)
+		{
+			static_assert(!APresentIn<info_t, IE>, "EXPLICIT LENGTH IS NOT SUPPORTED IN PATH");
+			auto const len = decode_len<info_t>(decoder);
+			if (has_failed(decoder)) { return; }
+			auto end = decoder(PUSH_SIZE{len});
+			if (has_failed(decoder)) { return; }
+			peek_ie<ctx, IE, PATH...>(decoder, out);
+		}
+		else
+		{
+			auto const tag = decode_tag<info_t>(decoder);
+			if (has_failed(decoder)) { return; }
+			if (not info_t::match(tag))
+			{
+				MED_RETURN_ERROR(decoder, unknown_tag, name<IE>(), tag)
+			}
+			peek_ie<ctx, IE, PATH...>(decoder, out);
+		}
+	}
+	else
+	{
+		using ie_type = typename IE::ie_type;
+		if constexpr (std::is_same_v<IE_SEQUENCE, ie_type>)
+		{
+			peek_sequence<IE, PATH...>(decoder, out);
+		}
+		else if constexpr (std::is_same_v<IE_SET, ie_type>)
+		{
+			peek_set_ie<IE, PATH...>(decoder, out);
+		}
+		else
+		{
+			static_assert(std::is_same_v<IE_CHOICE, ie_type>, "CONTAINER EXPECTED IN PATH");
+			peek_choice_ie<IE, PATH...>(decoder, out);
+		}
+	}
+}
+
+}	//end: namespace sl
+
+/**
+ * Extracts a single IE from the encoded message
+ * @details The encoded message is walked along the path of IEs w/o decoding
+ * the message: the cases of choices are followed only if selected, the IEs
+ * of sets not in the path are skipped by their length (or decoded into
+ * temporary if can't be skipped) and sequences are decoded up to the IE.
+ * Octet strings of the result refer to the input as usual.
+ * @tparam ROOT the message type
+ * @tparam PATH the fields to walk through ending with the one to peek
+ * @param decoder decoder which context is reset to the input
+ * @param input encoded message
+ * @return the field or nullopt if it is absent
+ */
+template <AHasIeType ROOT, class... PATH, class DECODER>
+constexpr auto peek(DECODER&& decoder, std::span<uint8_t const> input)
+{
+	static_assert(sizeof...(PATH) > 0, "PATH TO IE EXPECTED");
+	using leaf_t = typename decltype((std::type_identity<ROOT>{}, ..., std::type_identity<PATH>{}))::type;
+
+	std::optional<leaf_t> out;
+	decoder.get_context().reset(input.data(), input.size());
+	using mi = meta::produce_info_t<DECODER, ROOT>;
+	sl::peek_ie<type_context<typename ROOT::ie_type, mi>, ROOT, PATH...>(decoder, out);
+	return out;
+}
+
+}	//end: namespace med
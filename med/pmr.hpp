@@ -0,0 +1,98 @@
+/**
+@file
+adapters between MED allocators and std::pmr::memory_resource
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+#include "config.hpp"
+#include "allocator.hpp"
+#include "concepts.hpp"
+#include "debug.hpp"
+
+namespace med {
+
+/**
+ * Allocator for MED contexts on top of memory resource
+ * @details The resource is expected to release the memory in bulk
+ * (e.g. monotonic or pool resource reset per request) since
+ * MED never deallocates individual allocations.
+ */
+class pmr_allocator
+{
+public:
+	explicit pmr_allocator(std::pmr::memory_resource* res = std::pmr::get_default_resource()) noexcept
+		: m_resource{res} {}
+
+	[[nodiscard]]
+	void* allocate(std::size_t bytes, std::size_t alignment) noexcept
+	{
+#if MED_EXCEPTIONS
+		try
+		{
+			return m_resource->allocate(bytes, alignment);
+		}
+		catch (std::bad_alloc const&)
+		{
+			CODEC_TRACE("%s: failed to allocate %zu bytes", __FUNCTION__, bytes);
+			return nullptr;
+		}
+#else
+		//w/o exceptions the resource can't report failure (null isn't allowed)
+		if (void* p = m_resource->allocate(bytes, alignment)) { return p; }
+		CODEC_TRACE("%s: failed to allocate %zu bytes", __FUNCTION__, bytes);
+		std::abort();
+#endif
+	}
+
+	std::pmr::memory_resource* resource() const noexcept   { return m_resource; }
+
+private:
+	std::pmr::memory_resource* m_resource;
+};
+
+/**
+ * Memory resource on top of MED allocator (e.g. med::allocator or med::arena)
+ * @details Deallocation is a no-op as the memory is returned by release of
+ * the underlying allocator.
+ */
+template <AAllocator ALLOCATOR>
+class memory_resource : public std::pmr::memory_resource
+{
+public:
+	explicit memory_resource(ALLOCATOR& alloc) noexcept : m_alloc{alloc} {}
+
+	ALLOCATOR& get_allocator() noexcept                     { return m_alloc; }
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override
+	{
+		if (void* p = m_alloc.allocate(bytes, alignment)) { return p; }
+		CODEC_TRACE("%s: failed to allocate %zu bytes", __FUNCTION__, bytes);
+#if MED_EXCEPTIONS
+		throw std::bad_alloc{};
+#else
+		//null isn't allowed as the result
+		std::abort();
+#endif
+	}
+
+	void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+	bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	ALLOCATOR& m_alloc;
+};
+
+} //end: namespace med
@@ -168,6 +168,7 @@ private:
 template <class SINK, class IE, std::size_t MAX_LINE = 128>
 void print(SINK&& sink, IE const& ie, std::size_t max_depth = 0)
 {
+#if MED_EXCEPTIONS
 	try
 	{
 		encode(printer<SINK, MAX_LINE>{std::forward<SINK>(sink), max_depth}, ie);
@@ -176,6 +177,9 @@ void print(SINK&& sink, IE const& ie, std::size_t max_depth = 0)
 	{
 		sink.on_error(ex.what());
 	}
+#else
+	encode(printer<SINK, MAX_LINE>{std::forward<SINK>(sink), max_depth}, ie);
+#endif
 }
 
 
@@ -220,6 +224,7 @@ template <class SINK, class IE, std::size_t MAX_LINE = 128>
 void print_all(SINK&& sink, IE const& ie)
 {
 	dumper<SINK, MAX_LINE> d{std::forward<SINK>(sink)};
+#if MED_EXCEPTIONS
 	try
 	{
 		encode(d, ie);
@@ -228,6 +233,9 @@ void print_all(SINK&& sink, IE const& ie)
 	{
 		d.m_sink.on_error(ex.what());
 	}
+#else
+	encode(d, ie);
+#endif
 }
 
 } //namespace med
@@ -0,0 +1,107 @@
+/**
+@file
+decoding of selected IEs only
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "decode.hpp"
+#include "concepts.hpp"
+#include "meta/typelist.hpp"
+
+namespace med {
+
+//fields to decode while others are skipped
+template <class... FIELDS>
+struct only {};
+
+namespace sl {
+
+template <class IE, class... FIELDS>
+constexpr bool in_projection(only<FIELDS...>*)
+{
+	using field_t = get_field_type_t<IE>;
+	if constexpr ((std::is_same_v<field_t, FIELDS> || ...))
+	{
+		return true;
+	}
+	else if constexpr (requires { typename field_t::ies_types; }) //container holding projected fields
+	{
+		return []<class... IEs>(meta::typelist<IEs...>*)
+			{ return (in_projection<IEs>(static_cast<only<FIELDS...>*>(nullptr)) || ...); }
+			(static_cast<typename field_t::ies_types*>(nullptr));
+	}
+	else
+	{
+		return false;
+	}
+}
+
+//true if IE is to be decoded by the decoder (always unless projected)
+template <class DECODER, class IE>
+constexpr bool is_projected()
+{
+	using decoder_t = std::remove_cvref_t<DECODER>;
+	if constexpr (requires { typename decoder_t::projection; })
+	{
+		return in_projection<IE>(static_cast<typename decoder_t::projection*>(nullptr));
+	}
+	else
+	{
+		return true;
+	}
+}
+
+template <class DECODER>
+concept AProjecting = requires { typename std::remove_cvref_t<DECODER>::projection; };
+
+//decoder which skips the IEs not in projection
+template <class DECODER, class PROJECTION>
+struct projected_decoder : DECODER
+{
+	using projection = PROJECTION;
+
+	explicit projected_decoder(DECODER const& decoder) : DECODER{decoder} {}
+	explicit projected_decoder(DECODER&& decoder) : DECODER{std::move(decoder)} {}
+};
+
+//error policy (and its state) of codec
+template <class CODEC, class ERR_POLICY>
+constexpr ERR_POLICY& error_policy_of(error_handler<CODEC, ERR_POLICY>& codec) noexcept { return codec; }
+
+}	//end: namespace sl
+
+template <class T>
+concept AProjection = requires (T* p) { []<class... Fs>(only<Fs...>*){}(p); };
+
+/**
+ * Decodes only the fields of projection (and containers holding them)
+ * @details IEs of sets not in projection are skipped by their length
+ * w/o decoding as well as cases of choices not in projection while
+ * sequences are decoded as usual. IEs w/o skippable length are decoded.
+ * The arity of skipped IEs is not validated.
+ * The decoder is copied with its error policy, and the errors reported w/o
+ * exceptions are passed back to the caller's decoder.
+ */
+template <AProjection PROJECTION, class DECODER, AHasIeType IE, class... DEPS>
+constexpr auto decode(DECODER&& decoder, IE& ie, DEPS&... deps)
+{
+	using decoder_t = sl::projected_decoder<std::remove_cvref_t<DECODER>, PROJECTION>;
+	decoder_t projected{std::forward<DECODER>(decoder)};
+	decode(projected, ie, deps...);
+	//errors reported w/o exceptions are kept by caller's decoder
+	if constexpr (std::is_lvalue_reference_v<DECODER> && requires { sl::error_policy_of(decoder); })
+	{
+		sl::error_policy_of(decoder) = sl::error_policy_of(projected);
+	}
+	if constexpr (requires { projected.status(); }) { return projected.status(); }
+}
+
+}	//end: namespace med
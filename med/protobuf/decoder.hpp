@@ -9,6 +9,7 @@ Distributed under the MIT License
 
 #pragma once
 
+#include <algorithm>
 #include <utility>
 
 #include "exception.hpp"
@@ -20,26 +21,26 @@ Distributed under the MIT License
 
 namespace med::protobuf {
 
-template <class DEC_CTX>
-struct decoder : sl::octet_info
+template <class DEC_CTX, class ERR_POLICY = default_error_policy>
+struct decoder : sl::octet_info, error_handler<decoder<DEC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	using state_type = typename DEC_CTX::buffer_type::state_type;
 	using size_state = typename DEC_CTX::buffer_type::size_state;
 	using allocator_type = typename DEC_CTX::allocator_type;
 
-	explicit decoder(DEC_CTX& ctx_) : m_ctx{ctx_} { }
+	explicit decoder(DEC_CTX& ctx_, ERR_POLICY = {}) : m_ctx{ctx_} { }
 	DEC_CTX& get_context() noexcept             { return m_ctx; }
 	allocator_type& get_allocator()             { return get_context().get_allocator(); }
 
 	//state
-	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit); }
+	auto operator() (PUSH_SIZE ps)              { return get_context().buffer().push_size(ps.size, ps.commit, *this); }
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)     { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                 { get_context().buffer().pop_state(); }
 	auto operator() (GET_STATE)                 { return get_context().buffer().get_state(); }
 	template <class IE>
 	bool operator() (CHECK_STATE, IE const&)    { return !get_context().buffer().empty(); }
-	void operator() (ADVANCE_STATE ss)          { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta); }
+	void operator() (ADVANCE_STATE ss)          { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta, *this); }
 
 	//IE_TAG
 	template <class IE> [[nodiscard]] auto operator() (IE&, IE_TAG)
@@ -57,7 +58,7 @@ struct decoder : sl::octet_info
 	{
 		static_assert(0 == (IE::traits::bits % 8), "OCTET VALUE EXPECTED");
 		CODEC_TRACE("->VAL[%s] %zu bits: %s", name<IE>(), IE::traits::bits, get_context().buffer().toString());
-		typename IE::value_type val = get_context().buffer().template pop<IE>();
+		typename IE::value_type val = get_context().buffer().template pop<IE>(*this);
 		if (val & 0x80)
 		{
 			val &= 0x7F;
@@ -66,13 +67,13 @@ struct decoder : sl::octet_info
 			{
 				if (++count < MAX_VARINT_BYTES)
 				{
-					auto const byte = get_context().buffer().template pop<IE>();
+					auto const byte = get_context().buffer().template pop<IE>(*this);
 					val |= static_cast<typename IE::value_type>(byte & 0x7F) << (7 * count);
 					if (0 == (byte & 0x80)) { break; }
 				}
 				else
 				{
-					MED_THROW_EXCEPTION(invalid_value, name<IE>(), val, get_context().buffer())
+					MED_RETURN_ERROR(*this, invalid_value, name<IE>(), val, get_context().buffer())
 				}
 			}
 		}
@@ -81,7 +82,7 @@ struct decoder : sl::octet_info
 		{
 			if (not ie.set_encoded(val))
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<IE>(), val, get_context().buffer())
+				MED_RETURN_ERROR(*this, invalid_value, name<IE>(), val, get_context().buffer())
 			}
 		}
 		else
@@ -96,14 +97,21 @@ struct decoder : sl::octet_info
 	void operator() (IE& ie, IE_OCTET_STRING)
 	{
 		CODEC_TRACE("STR[%s] <-(%zu bytes): %s", name<IE>(), get_context().buffer().size(), get_context().buffer().toString());
-		if (ie.set_encoded(get_context().buffer().size(), get_context().buffer().begin()))
+		auto& buf = get_context().buffer();
+		auto const* data = buf.begin();
+		if constexpr (requires { buf.template view<IE>(0, *this); }) //non-contiguous input
+		{
+			data = buf.template view<IE>(std::min(buf.size(), std::size_t(IE::traits::max_octets)), *this);
+			if (!data) { return; }
+		}
+		if (ie.set_encoded(buf.size(), data))
 		{
 			CODEC_TRACE("STR[%s] -> len = %zu bytes", name<IE>(), std::size_t(ie.size()));
-			get_context().buffer().template advance<IE>(ie.size());
+			get_context().buffer().template advance<IE>(ie.size(), *this);
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(invalid_value, name<IE>(), ie.size(), get_context().buffer())
+			MED_RETURN_ERROR(*this, invalid_value, name<IE>(), ie.size(), get_context().buffer())
 		}
 	}
 
@@ -112,5 +120,6 @@ private:
 };
 
 template <class C> explicit decoder(C&) -> decoder<C>;
+template <class C, class E> decoder(C&, E) -> decoder<C, E>;
 
 }	//end: namespace med::protobuf
@@ -17,14 +17,14 @@ Distributed under the MIT License
 
 namespace med::protobuf {
 
-template <class ENC_CTX>
-struct encoder : sl::octet_info
+template <class ENC_CTX, class ERR_POLICY = default_error_policy>
+struct encoder : sl::octet_info, error_handler<encoder<ENC_CTX, ERR_POLICY>, ERR_POLICY>
 {
 	//required for length_encoder
 	using state_type = typename ENC_CTX::buffer_type::state_type;
 	using allocator_type = typename ENC_CTX::allocator_type;
 
-	explicit encoder(ENC_CTX& ctx_) : m_ctx{ ctx_ }   { }
+	explicit encoder(ENC_CTX& ctx_, ERR_POLICY = {}) : m_ctx{ ctx_ } { }
 	ENC_CTX& get_context() noexcept                   { return m_ctx; }
 	allocator_type& get_allocator()                   { return get_context().get_allocator(); }
 
@@ -43,20 +43,26 @@ struct encoder : sl::octet_info
 			}
 			else
 			{
-				MED_THROW_EXCEPTION(invalid_value, name<IE>(), len, get_context().buffer())
+				MED_RETURN_ERROR(*this, invalid_value, name<IE>(), len, get_context().buffer())
 			}
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0, get_context().buffer())
+			MED_RETURN_ERROR(*this, missing_ie, name<IE>(), 1, 0, get_context().buffer())
 		}
 	}
 
 	template <class IE>
 	bool operator() (PUSH_STATE, IE const&)           { return get_context().buffer().push_state(); }
 	void operator() (POP_STATE)                       { get_context().buffer().pop_state(); }
-	void operator() (ADVANCE_STATE ss)                { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta); }
-	void operator() (SNAPSHOT ss)                     { get_context().put_snapshot(ss); }
+	void operator() (ADVANCE_STATE ss)                { get_context().buffer().template advance<ADVANCE_STATE>(ss.delta, *this); }
+	void operator() (SNAPSHOT ss)
+	{
+		if (not get_context().put_snapshot(ss))
+		{
+			MED_RETURN_ERROR(*this, out_of_memory, ss.id, ss.size, get_context().buffer())
+		}
+	}
 
 	//IE_TAG/IE_LEN
 	template <class IE> void operator() (IE const& ie, IE_TAG)
@@ -73,11 +79,11 @@ struct encoder : sl::octet_info
 		//TODO: estimate exact size needed? will it be faster?
 		while (value >= 0x80)
 		{
-			get_context().buffer().template push<IE>(value | 0x80);
+			get_context().buffer().template push<IE>(value | 0x80, *this);
 			CODEC_TRACE("\twrote %#02X, value=%#zX", uint8_t(value|0x80), std::size_t(value >> 7));
 			value >>= 7;
 		}
-		get_context().buffer().template push<IE>(value);
+		get_context().buffer().template push<IE>(value, *this);
 		CODEC_TRACE("\twrote value %02X", uint8_t(value));
 	}
 
@@ -85,7 +91,8 @@ struct encoder : sl::octet_info
 	template <class IE>
 	void operator() (IE const& ie, IE_OCTET_STRING)
 	{
-		uint8_t* out = get_context().buffer().template advance<IE>(ie.size());
+		uint8_t* out = get_context().buffer().template advance<IE>(ie.size(), *this);
+		if (!out) { return; }
 		octets<IE::traits::min_octets, IE::traits::max_octets>::copy(out, ie.data(), ie.size());
 		CODEC_TRACE("STR[%s] %zu octets: %s", name<IE>(), ie.size(), get_context().buffer().toString());
 	}
@@ -95,5 +102,6 @@ private:
 };
 
 template <class C> explicit encoder(C&) -> encoder<C>;
+template <class C, class E> encoder(C&, E) -> encoder<C, E>;
 
 }	//end: namespace med::protobuf
@@ -0,0 +1,376 @@
+/**
+@file
+decoder buffer over a chain of non-contiguous segments
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include "buffer.hpp"
+
+namespace med {
+
+/**
+ * Decoder buffer walking a chain of segments (e.g. fixed-size chunks of ring buffer)
+ * @details Positions are logical offsets in the concatenated data. A value within
+ * a segment is read in place, only a value crossing the segment boundary is
+ * stitched into a temporary. Octet strings within a segment are zero-copy, crossing
+ * ones are stitched into the internal arena of STITCH_SIZE octets which lives
+ * until the buffer is reset.
+ * NOTE: the chain of segments must outlive the decoding.
+ */
+template <std::size_t STITCH_SIZE = 256, std::size_t LEN_DEPTH = 16>
+class segmented_buffer
+{
+	using eob_index_t = uint8_t;
+	static constexpr std::size_t INVALID = std::numeric_limits<std::size_t>::max();
+
+public:
+	using pointer = uint8_t const*;
+	using value_type = uint8_t;
+	static constexpr bool is_const_v = true;
+
+	constexpr segmented_buffer() noexcept = default;
+	segmented_buffer(segmented_buffer const&) = delete;
+	segmented_buffer& operator=(segmented_buffer const&) = delete;
+
+	//captures current state of the buffer
+	class state_type
+	{
+	public:
+		constexpr explicit operator bool() const  { return INVALID != pos; }
+		constexpr void reset(std::size_t p = INVALID) { pos = p; }
+
+		friend constexpr std::ptrdiff_t operator- (state_type const& rhs, state_type const& lhs)
+		{
+			return std::ptrdiff_t(rhs.pos - lhs.pos);
+		}
+
+	private:
+		friend class segmented_buffer;
+
+		std::size_t pos{INVALID};
+	};
+
+	using size_state = detail::buffer_size_state<segmented_buffer>;
+
+	constexpr auto push_size(std::size_t size, bool commit_, auto&& err)
+	{
+		if (size <= this->size()) //within the current end of buffer
+		{
+			std::size_t& ps = m_eob[m_eob_index];
+			if (commit_)
+			{
+				ps = m_end;
+				m_end = m_pos + size;
+			}
+			else
+			{
+				ps = m_pos + size;
+			}
+			CODEC_TRACE("%u: change by %zu end%s: %s", m_eob_index, size, commit_ ? "" : " PENDING", toString());
+			return size_state{this, m_eob_index++, commit_};
+		}
+		else
+		{
+			err.template on_error<overflow>("end of buffer", size, *this);
+			return size_state{};
+		}
+	}
+	constexpr auto push_size(std::size_t size, bool commit_)    { return push_size(size, commit_, throw_on_error{}); }
+
+	//restarts decoding from the beginning of the same chain
+	constexpr void reset() noexcept
+	{
+		m_pos = 0;
+		m_end = m_total;
+		m_eob_index = 0;
+		m_store.reset();
+		m_used = 0;
+		m_seg = 0;
+		m_seg_begin = 0;
+		m_seg_end = m_segs.empty() ? 0 : m_segs[0].iov_len;
+		locate();
+	}
+	constexpr void reset(std::span<::iovec const> segs) noexcept
+	{
+		m_segs = segs;
+		m_total = 0;
+		for (auto const& seg : m_segs) { m_total += seg.iov_len; }
+		reset();
+	}
+	//single contiguous segment
+	constexpr void reset(void const* p, std::size_t s) noexcept
+	{
+		m_single = ::iovec{const_cast<void*>(p), s};
+		reset(std::span<::iovec const>{&m_single, 1});
+	}
+
+	constexpr state_type get_state() const noexcept         { state_type st; st.pos = m_pos; return st; }
+	constexpr void set_state(state_type const& st) noexcept { move_to(st.pos); }
+
+	constexpr bool push_state()
+	{
+		if (not empty())
+		{
+			m_store = get_state();
+			return true;
+		}
+		m_store.reset();
+		return false;
+	}
+
+	constexpr void pop_state()
+	{
+		if (m_store)
+		{
+			set_state(m_store);
+			m_store.reset();
+		}
+	}
+
+	constexpr std::size_t get_offset() const noexcept       { return m_pos; }
+	constexpr std::size_t size() const noexcept             { return m_end > m_pos ? m_end - m_pos : 0; }
+	constexpr bool empty() const noexcept                   { return m_pos >= m_end; }
+	explicit constexpr operator bool() const noexcept       { return !empty(); }
+	//number of nested size scopes (lengths) currently applied
+	constexpr std::size_t depth() const noexcept            { return m_eob_index; }
+
+	//current position within the current segment (not contiguous beyond it)
+	constexpr pointer begin() const noexcept
+	{
+		return m_segs.empty() ? nullptr : seg_data() + (m_pos - m_seg_begin);
+	}
+
+	template <class IE> constexpr value_type pop(auto&& err)
+	{
+		if (not empty())
+		{
+			auto const v = *begin();
+			move_to(m_pos + 1);
+			return v;
+		}
+		err.template on_error<overflow>(name<IE>(), sizeof(value_type), *this);
+		return {};
+	}
+	template <class IE> constexpr value_type pop()       { return pop<IE>(throw_on_error{}); }
+
+	template <class IE, size_t DELTA> constexpr pointer advance(auto&& err)
+	{
+		if (size() < DELTA)
+		{
+			err.template on_error<overflow>(name<IE>(), DELTA, *this);
+			return nullptr;
+		}
+		auto const p = fetch<DELTA>();
+		move_to(m_pos + DELTA);
+		return p;
+	}
+	template <class IE, size_t DELTA> constexpr pointer advance()
+		{ return advance<IE, DELTA>(throw_on_error{}); }
+
+	template <class IE, size_t BITS> constexpr pointer advance_bits(auto&& err)
+	{
+		constexpr auto NUM_BYTES = bits_to_bytes(BITS); //ceil to include traling byte if any
+		if (size() < NUM_BYTES)
+		{
+			err.template on_error<overflow>(name<IE>(), NUM_BYTES, *this);
+			return nullptr;
+		}
+		auto const p = fetch<NUM_BYTES>();
+		move_to(m_pos + BITS / 8); //floor to not include trailing byte
+		return p;
+	}
+	template <class IE, size_t BITS> constexpr pointer advance_bits()
+		{ return advance_bits<IE, BITS>(throw_on_error{}); }
+
+	//NOTE: returned pointer is contiguous within current segment only
+	template <class IE = void> constexpr pointer advance(int delta, auto&& err)
+	{
+		pointer p = nullptr;
+		if (delta >= 0 && size() >= std::size_t(delta))
+		{
+			p = begin();
+			move_to(m_pos + delta);
+		}
+		else if (delta < 0 && std::size_t(-delta) <= m_pos)
+		{
+			move_to(m_pos + delta);
+			p = begin();
+		}
+		else if constexpr (not std::is_void_v<IE>)
+		{
+			err.template on_error<overflow>(name<IE>(), delta, *this);
+		}
+		return p;
+	}
+	template <class IE = void> constexpr pointer advance(int delta)
+		{ return advance<IE>(delta, throw_on_error{}); }
+
+	/**
+	 * Provides contiguous view of the data at current position w/o advancing
+	 * @details The data crossing the segment boundary is stitched into the arena
+	 * @return pointer to the data or nullptr if no space to stitch
+	 */
+	template <class IE> constexpr pointer view(std::size_t count, auto&& err)
+	{
+		if (count > size())
+		{
+			err.template on_error<overflow>(name<IE>(), count, *this);
+			return nullptr;
+		}
+		if (m_pos + count <= m_seg_end) { return begin(); }
+		if (m_used + count > STITCH_SIZE)
+		{
+			err.template on_error<out_of_memory>(name<IE>(), count, *this);
+			return nullptr;
+		}
+		uint8_t* p = m_arena + m_used;
+		copy_out(p, count);
+		m_used += count;
+		CODEC_TRACE("stitched %zu octets [%s]: %s", count, name<IE>(), toString());
+		return p;
+	}
+
+	/**
+	 * Stops processing of the rest of buffer
+	 * @details Used after error reported w/o exception to fail all subsequent reads
+	 */
+	constexpr void halt() noexcept
+	{
+		std::size_t last = m_end;
+		for (eob_index_t i = 0; i < m_eob_index; ++i) { last = std::max(last, m_eob[i]); }
+		for (eob_index_t i = 0; i < m_eob_index; ++i) { m_eob[i] = last; }
+		m_end = last;
+		move_to(last);
+		m_store.reset();
+	}
+
+	char const* toString() const
+	{
+		static char sz[64];
+		int n = std::snprintf(sz, sizeof(sz), "#%d+%zu/%zu=", int(size()), m_pos, m_seg);
+		auto p = begin();
+		for (auto i = m_pos, to = std::min(m_end, std::min(m_seg_end, m_pos + 10)); i < to; ++i, ++p)
+		{
+			n += std::snprintf(sz+n, sizeof(sz)-n, i == m_pos ? "[%02X]":"%02X", *p);
+		}
+		return sz;
+	}
+
+	friend std::ostream& operator << (std::ostream& out, segmented_buffer const& buf)
+	{
+		return out << buf.toString();
+	}
+
+private:
+	friend size_state;
+
+	constexpr pointer seg_data() const noexcept
+	{
+		return static_cast<pointer>(m_segs[m_seg].iov_base);
+	}
+
+	//moves the current segment to contain the position
+	constexpr void locate() noexcept
+	{
+		while (m_pos >= m_seg_end && m_seg + 1 < m_segs.size())
+		{
+			m_seg_begin = m_seg_end;
+			m_seg_end += m_segs[++m_seg].iov_len;
+		}
+		while (m_pos < m_seg_begin)
+		{
+			m_seg_end = m_seg_begin;
+			m_seg_begin -= m_segs[--m_seg].iov_len;
+		}
+	}
+
+	constexpr void move_to(std::size_t pos) noexcept
+	{
+		m_pos = pos;
+		if (m_pos >= m_seg_end || m_pos < m_seg_begin) { locate(); }
+	}
+
+	//copies data from the current position across segments
+	constexpr void copy_out(uint8_t* out, std::size_t count) const noexcept
+	{
+		auto seg = m_seg;
+		auto ofs = m_pos - m_seg_begin;
+		while (count)
+		{
+			auto const& s = m_segs[seg];
+			auto const n = std::min(count, s.iov_len - ofs);
+			std::memcpy(out, static_cast<pointer>(s.iov_base) + ofs, n);
+			out += n;
+			count -= n;
+			++seg;
+			ofs = 0;
+		}
+	}
+
+	//pointer to N contiguous octets at current position (size is checked)
+	template <std::size_t N>
+	constexpr pointer fetch() noexcept
+	{
+		static_assert(N <= sizeof(m_temp), "VALUE TOO LONG TO STITCH");
+		if (m_pos + N <= m_seg_end) { return begin(); }
+		copy_out(m_temp, N);
+		return m_temp;
+	}
+
+	constexpr void restore_end(size_state& ss)
+	{
+		if (ss.m_commited && !ss.empty())
+		{
+			m_end = m_eob[ss.m_index];
+			--m_eob_index;
+			CODEC_TRACE("%u/%u: restored end: %s", ss.m_index, m_eob_index, toString());
+			ss.clear();
+		}
+	}
+
+	constexpr void commit_end(size_state& ss, int delta)
+	{
+		if (!(ss.m_commited || ss.empty()))
+		{
+			ss.m_commited = true;
+			std::size_t& ps1 = m_eob[ss.m_index];
+			ps1 += delta; //end to be set by dependent
+			if (ss.m_index + 1 < m_eob_index) //adjust the deeper level's ends
+			{
+				std::size_t& ps2 = m_eob[ss.m_index+1];
+				std::swap(ps1, ps2);
+			}
+			else
+			{
+				m_end = ps1;
+				//replace EoB from previous level to restore properly
+				if (ss.m_index > 0) { ps1 = m_eob[ss.m_index - 1]; }
+			}
+			CODEC_TRACE("%u/%u: commit adjusted by %d: %s", ss.m_index, m_eob_index, delta, toString());
+		}
+	}
+
+	std::span<::iovec const> m_segs{};
+	::iovec        m_single{};
+	std::size_t    m_total{0};
+	std::size_t    m_pos{0};
+	std::size_t    m_end{0};
+	std::size_t    m_seg{0};
+	std::size_t    m_seg_begin{0};
+	std::size_t    m_seg_end{0};
+	state_type     m_store{};
+	uint8_t        m_eob_index{0};
+	std::size_t    m_eob[LEN_DEPTH]{};
+	std::size_t    m_used{0};
+	uint8_t        m_temp[16]{};
+	uint8_t        m_arena[STITCH_SIZE]{};
+};
+
+}	//end: namespace med
@@ -17,6 +17,7 @@ Distributed under the MIT License
 #include "debug.hpp"
 #include "meta/typelist.hpp"
 #include "meta/foreach.hpp"
+#include "sl/fixed_layout.hpp"
 
 namespace med {
 
@@ -39,7 +40,7 @@ constexpr void encode_multi(FUNC& func, IE const& ie)
 	using ctx = type_context<typename IE::ie_type, mi>;
 
 	CODEC_TRACE("%s *%zu", name<IE>(), ie.count());
-	for (auto& field : ie)
+	foreach_field(func, ie, [&](auto const& field)
 	{
 		CODEC_TRACE("[%s]%c", name<IE>(), field.is_set() ? '+':'-');
 		if (field.is_set())
@@ -48,8 +49,27 @@ constexpr void encode_multi(FUNC& func, IE const& ie)
 		}
 		else
 		{
-			MED_THROW_EXCEPTION(missing_ie, name<IE>(), ie.count(), ie.count() - 1)
+			MED_RETURN_ERROR(func, missing_ie, name<IE>(), ie.count(), ie.count() - 1)
 		}
+	});
+}
+
+//multi-field preceded by its counter
+template <class FUNC, class IE>
+constexpr void encode_counted(FUNC& func, IE const& ie)
+{
+	typename IE::counter_type counter_ie;
+	counter_ie.set_encoded(ie.count());
+	check_arity(func, ie);
+	if constexpr (is_back_to_front_v<FUNC>)
+	{
+		encode_multi(func, ie);
+		med::encode(func, counter_ie);
+	}
+	else
+	{
+		med::encode(func, counter_ie);
+		encode_multi(func, ie);
 	}
 }
 
@@ -82,7 +102,12 @@ struct seq_dec
 				while (type::match(vtag.get_encoded()))
 				{
 					CODEC_TRACE("->T=%zX[%s]*%zu", vtag.get_encoded(), name<IE>(), ie.count()+1);
+					if (ie.count() >= IE::max)
+					{
+						MED_RETURN_ERROR(decoder, extra_ie, name<IE>(), IE::max, ie.count() + 1)
+					}
 					auto* field = ie.push_back(decoder);
+					if (!field) { return; }
 					using ctx_next = type_context<typename CTX::ie_type, meta::list_rest_t<mi>, EXP_TAG, EXP_LEN>;
 					ie_decode<ctx_next>(decoder, *field, deps...);
 
@@ -126,10 +151,12 @@ struct seq_dec
 
 					CODEC_TRACE("[%s] CNT=%zu", name<IE>(), std::size_t(count));
 					check_arity(decoder, ie, count);
+					if (has_failed(decoder) || !ie.reserve(ie.count() + count, decoder)) { return; }
 					while (count--)
 					{
 						auto* field = ie.push_back(decoder);
 						CODEC_TRACE("#%zu = %p", std::size_t(count), (void*)field);
+						if (!field) { return; }
 						med::decode(decoder, *field, deps...);
 					}
 				}
@@ -141,9 +168,10 @@ struct seq_dec
 						{
 							CODEC_TRACE("C[%s]#%zu", name<IE>(), ie.count());
 							auto* field = ie.push_back(decoder);
+							if (!field) { return; }
 							med::decode(decoder, *field, deps...);
 						}
-						while (typename IE::condition{}(to));
+						while (typename IE::condition{}(to) && not has_failed(decoder));
 
 						check_arity(decoder, ie);
 					}
@@ -159,6 +187,7 @@ struct seq_dec
 					while (decoder(CHECK_STATE{}, ie) && count < IE::max)
 					{
 						auto* field = ie.push_back(decoder);
+						if (!field) { return; }
 						ie_decode<ctx>(decoder, *field, deps...);
 						++count;
 					}
@@ -270,22 +299,14 @@ struct seq_enc
 					CODEC_TRACE("CV[%s]=%zu", name<IE>(), ie.count());
 					if (count > 0)
 					{
-						typename IE::counter_type counter_ie;
-						counter_ie.set_encoded(ie.count());
-						check_arity(encoder, ie);
-						med::encode(encoder, counter_ie);
-						encode_multi(encoder, ie);
+						encode_counted(encoder, ie);
 					}
 				}
 				//mandatory multi-field w/ counter w/o tag
 				else
 				{
 					CODEC_TRACE("CV{%s}=%zu", name<IE>(), ie.count());
-					typename IE::counter_type counter_ie;
-					counter_ie.set_encoded(ie.count());
-					check_arity(encoder, ie);
-					med::encode(encoder, counter_ie);
-					encode_multi(encoder, ie);
+					encode_counted(encoder, ie);
 				}
 			}
 			else //multi-field w/o counter
@@ -309,7 +330,7 @@ struct seq_enc
 					{
 						if (not setter(ie, to))
 						{
-							MED_THROW_EXCEPTION(invalid_value, name<IE>(), ie.get())
+							MED_RETURN_ERROR(encoder, invalid_value, name<IE>(), ie.get())
 						}
 					}
 					else
@@ -344,7 +365,7 @@ struct seq_enc
 					{
 						if (not setter(ie, to))
 						{
-							MED_THROW_EXCEPTION(invalid_value, name<IE>(), ie.get())
+							MED_RETURN_ERROR(encoder, invalid_value, name<IE>(), ie.get())
 						}
 					}
 					else
@@ -357,7 +378,7 @@ struct seq_enc
 					}
 					else
 					{
-						MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0)
+						MED_RETURN_ERROR(encoder, missing_ie, name<IE>(), 1, 0)
 					}
 				}
 				else //w/o setter
@@ -369,7 +390,7 @@ struct seq_enc
 					}
 					else
 					{
-						MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0)
+						MED_RETURN_ERROR(encoder, missing_ie, name<IE>(), 1, 0)
 					}
 				}
 			}
@@ -388,13 +409,23 @@ struct sequence : container<IE_SEQUENCE, IES...>
 	template <class IE_LIST>
 	void encode(auto& encoder) const
 	{
-		meta::foreach_prev<IE_LIST, void>(sl::seq_enc{}, this->m_ies, encoder);
+		if constexpr (sl::AFixedLayout<std::remove_reference_t<decltype(encoder)>, IE_LIST, decltype(this->m_ies)>)
+		{
+			if (encoder(sl::FIXED_LAYOUT<IE_LIST>{}, this->m_ies)) { return; }
+		}
+		meta::foreach_prev<sl::encode_order_t<decltype(encoder), IE_LIST>, void>(sl::seq_enc{}, this->m_ies, encoder);
 	}
 	void encode(auto& encoder) const { encode<ies_types>(encoder); }
 
 	template <class IE_LIST, class TYPE_CTX = type_context<IE_SEQUENCE>>
 	void decode(auto& decoder, auto&... deps)
 	{
+		this->m_ies.present |= this->template presence_of<IE_LIST>();
+		if constexpr (std::is_void_v<typename TYPE_CTX::explicit_length_type>
+			&& sl::AFixedLayout<std::remove_reference_t<decltype(decoder)>, IE_LIST, decltype(this->m_ies)>)
+		{
+			if (decoder(sl::FIXED_LAYOUT<IE_LIST>{}, this->m_ies)) { return; }
+		}
 		value<std::size_t> vtag;
 		meta::foreach_prev<IE_LIST, TYPE_CTX>(sl::seq_dec{}, this->m_ies, decoder, vtag, deps...);
 	}
@@ -17,6 +17,8 @@ Distributed under the MIT License
 #include "decode.hpp"
 #include "name.hpp"
 #include "tag.hpp"
+#include "projection.hpp"
+#include "sl/ie_skip.hpp"
 #include "meta/unique.hpp"
 
 namespace med {
@@ -45,7 +47,7 @@ inline constexpr void encode_single(FUNC& func, IE const& ie)
 	}
 	else if constexpr (!AOptional<IE>)
 	{
-		MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0)
+		MED_RETURN_ERROR(func, missing_ie, name<IE>(), 1, 0)
 	}
 }
 
@@ -87,10 +89,10 @@ struct set_enc
 			CODEC_TRACE("[%s]*%zu: %s", name<IE>(), ie.count(), class_name<mi>());
 			check_arity(encoder, ie);
 
-			for (auto& field : ie)
+			foreach_field(encoder, ie, [&](auto const& field)
 			{
 				//field was pushed but not set... do we need a new error?
-				if (not field.is_set()) { MED_THROW_EXCEPTION(missing_ie, name<IE>(), ie.count(), ie.count()-1) }
+				if (not field.is_set()) { MED_RETURN_ERROR(encoder, missing_ie, name<IE>(), ie.count(), ie.count()-1) }
 
 				if constexpr (explicit_meta)
 				{
@@ -102,7 +104,7 @@ struct set_enc
 					using ctx = type_context<IE_SET, mi>;
 					sl::ie_encode<ctx>(encoder, field);
 				}
-			}
+			});
 		}
 		else //single-instance field
 		{
@@ -117,7 +119,7 @@ struct set_enc
 				{
 					if (not setter(ie, to))
 					{
-						MED_THROW_EXCEPTION(invalid_value, name<IE>(), ie.get())
+						MED_RETURN_ERROR(encoder, invalid_value, name<IE>(), ie.get())
 					}
 				}
 				else
@@ -154,14 +156,16 @@ struct set_dec
 		if constexpr (!APredefinedValue<tag_t>) { decoder(POP_STATE{}); }
 
 		IE& ie = to;
+		to.template mark<IE>();
 		if constexpr (AMultiField<IE>)
 		{
 			CODEC_TRACE("[%s]*%zu", name<IE>(), ie.count());
 			if (ie.count() >= IE::max)
 			{
-				MED_THROW_EXCEPTION(extra_ie, name<IE>(), IE::max, ie.count())
+				MED_RETURN_ERROR(decoder, extra_ie, name<IE>(), IE::max, ie.count())
 			}
 			auto* field = ie.push_back(decoder);
+			if (!field) { return; }
 			sl::ie_decode<type_context<IE_SET, meta::list_rest_t<mi>>>(decoder, *field, deps...);
 		}
 		else //single-instance field
@@ -172,14 +176,43 @@ struct set_dec
 				return sl::ie_decode<type_context<IE_SET, meta::list_rest_t<mi>>>(decoder, ie, deps...);
 				//return med::decode(decoder, ie);
 			}
-			MED_THROW_EXCEPTION(extra_ie, name<IE>(), 2, 1)
+			MED_RETURN_ERROR(decoder, extra_ie, name<IE>(), 2, 1)
 		}
 	}
 
 	template <class TO, class DECODER, class HEADER, class... DEPS>
-	static constexpr void apply(TO&, DECODER&, HEADER const& header, DEPS&...)
+	static constexpr void apply(TO&, DECODER& decoder, HEADER const& header, DEPS&...)
 	{
-		MED_THROW_EXCEPTION(unknown_tag, name<TO>(), get_tag(header))
+		MED_RETURN_ERROR(decoder, unknown_tag, name<TO>(), get_tag(header))
+	}
+};
+
+//decodes IEs of projection while skipping others
+struct set_dec_only
+{
+	template <class IE, class TO, class DECODER, class HEADER, class STATE, class... DEPS>
+	static bool check(TO& to, DECODER& decoder, HEADER const& header, STATE const&, DEPS&...)
+	{
+		return set_dec::check<IE>(to, decoder, header);
+	}
+
+	template <class IE, class TO, class DECODER, class HEADER, class STATE, class... DEPS>
+	static constexpr void apply(TO& to, DECODER& decoder, HEADER const& header, STATE const& ie_start, DEPS&... deps)
+	{
+		if constexpr (is_projected<DECODER, IE>())
+		{
+			set_dec::apply<IE>(to, decoder, header, deps...);
+		}
+		else
+		{
+			skip_ie<IE>(decoder, ie_start);
+		}
+	}
+
+	template <class TO, class DECODER, class HEADER, class STATE, class... DEPS>
+	static constexpr void apply(TO& to, DECODER& decoder, HEADER const& header, STATE const&, DEPS&...)
+	{
+		set_dec::apply(to, decoder, header);
 	}
 };
 
@@ -188,6 +221,7 @@ struct set_check
 	template <class IE, class TO, class DECODER>
 	static constexpr void apply(TO const& to, DECODER& decoder)
 	{
+		if constexpr (!is_projected<DECODER, IE>()) { return; } //skipped w/o decoding
 		IE const& ie = to;
 		if constexpr (AMultiField<IE>)
 		{
@@ -197,7 +231,7 @@ struct set_check
 		{
 			if (not (AOptional<IE> || ie.is_set()))
 			{
-				MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0)
+				MED_RETURN_ERROR(decoder, missing_ie, name<IE>(), 1, 0)
 			}
 		}
 
@@ -207,8 +241,8 @@ struct set_check
 			if (ie.is_set() != should_be_set)
 			{
 				CODEC_TRACE("%cC[%s] %s be set in %s", ie.is_set() ? '+' : '-', name<IE>(), should_be_set ? "MUST" : "must NOT", name<TO>());
-				if (should_be_set) { MED_THROW_EXCEPTION(missing_ie, name<IE>(), 1, 0); }
-				else               { MED_THROW_EXCEPTION(extra_ie,   name<IE>(), 0, 1); }
+				if (should_be_set) { MED_RETURN_ERROR(decoder, missing_ie, name<IE>(), 1, 0); }
+				else               { MED_RETURN_ERROR(decoder, extra_ie,   name<IE>(), 0, 1); }
 			}
 		}
 	}
@@ -251,7 +285,7 @@ struct set : detail::set_container<meta::typelist<IEs...>>
 	template <class ENCODER>
 	void encode(ENCODER& encoder) const
 	{
-		meta::foreach_prev<ies_types, void>(sl::set_enc{}, this->m_ies, encoder);
+		meta::foreach_prev<sl::encode_order_t<ENCODER, ies_types>, void>(sl::set_enc{}, this->m_ies, encoder);
 	}
 
 	template <class DECODER, class... DEPS>
@@ -261,6 +295,9 @@ struct set : detail::set_container<meta::typelist<IEs...>>
 			, "SEE ERROR ON INCOMPLETE TYPE/UNDEFINED TEMPLATE HOLDING IEs WITH CLASHED TAGS");
 		//?TODO: check all IEs have covariant tag
 
+		//IEs decoded now are told apart from ones set before
+		auto const present = this->m_ies.present;
+		this->m_ies.present.clear();
 		if constexpr (set::plain_header)
 		{
 			using IE = meta::list_first_t<ies_types>; //use 1st IE since all have similar tag
@@ -269,10 +306,18 @@ struct set : detail::set_container<meta::typelist<IEs...>>
 
 			while (decoder(PUSH_STATE{}, *this))
 			{
+				[[maybe_unused]] auto const ie_start = decoder(GET_STATE{});
 				value<std::size_t> header;
 				header.set_encoded(sl::decode_tag<tag_t>(decoder));
 				CODEC_TRACE("tag=%#zX mi=%s firstIE=%s tag_t=%s", std::size_t(get_tag(header)), class_name<mi>(), name<IE>(), name<tag_t>());
-				meta::for_if<ies_types>(sl::set_dec{}, this->m_ies, decoder, header, deps...);
+				if constexpr (sl::AProjecting<DECODER>)
+				{
+					sl::for_tag<ies_types, DECODER>(get_tag(header), sl::set_dec_only{}, this->m_ies, decoder, header, ie_start, deps...);
+				}
+				else
+				{
+					sl::for_tag<ies_types, DECODER>(get_tag(header), sl::set_dec{}, this->m_ies, decoder, header, deps...);
+				}
 			}
 		}
 		else //compound header
@@ -284,11 +329,36 @@ struct set : detail::set_container<meta::typelist<IEs...>>
 				med::decode(decoder, header, deps...);
 				decoder(POP_STATE{}); //restore back for IE to decode itself (?TODO: better to copy instead)
 				CODEC_TRACE("tag=%#zX hdr=%s", std::size_t(get_tag(header)), class_name<header_type>());
-				meta::for_if<ies_types>(sl::set_dec{}, this->m_ies, decoder, header, deps...);
+				sl::for_tag<ies_types, DECODER>(get_tag(header), sl::set_dec{}, this->m_ies, decoder, header, deps...);
 			}
 		}
+		auto const decoded = this->m_ies.present;
+		this->m_ies.present |= present;
+		//all mandatory IEs are decoded => nothing else to check
+		if constexpr (simple_check())
+		{
+			if (decoded.covers(mandatory_ies())) { return; }
+		}
 		meta::foreach<ies_types>(sl::set_check{}, this->m_ies, decoder);
 	}
+
+private:
+	//all IEs are single-instance and unconditional
+	static constexpr bool simple_check()
+	{
+		return []<class... IES>(meta::typelist<IES...>*) { return ((!AMultiField<IES> && !AHasCondition<IES>) && ...); }
+			(static_cast<ies_types*>(nullptr));
+	}
+
+	static constexpr auto mandatory_ies()
+	{
+		return []<class... IES>(meta::typelist<IES...>*)
+		{
+			typename set::presence_t p;
+			((AOptional<IES> ? void() : p.set(meta::list_index_of_v<IES, ies_types>)), ...);
+			return p;
+		}(static_cast<ies_types*>(nullptr));
+	}
 };
 
 }	//end: namespace med
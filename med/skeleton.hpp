@@ -0,0 +1,290 @@
+/**
+@file
+pre-encoded message with variable IEs patched on each emit
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+
+#include "encode.hpp"
+#include "encoder_context.hpp"
+#include "octet_encoder.hpp"
+#include "snapshot.hpp"
+
+namespace med {
+
+namespace detail {
+
+//placement of variable IE in skeleton
+struct skeleton_var
+{
+	static constexpr std::size_t npos = std::size_t(-1);
+
+	std::size_t pos{npos};
+	std::size_t size{};
+	bool        resizable{true}; //all enclosing lengths can be patched
+};
+
+//length written back by encoder after the IEs it covers
+struct skeleton_len
+{
+	std::size_t pos;
+	std::size_t value;   //as encoded
+	std::uint64_t vars;  //mask of enclosed variable IEs
+	uint8_t     width;   //in octets
+};
+
+/**
+ * Octet encoder recording the snapshots of variable IEs and the lengths
+ * enclosing them which are written back (see encode_backpatched)
+ */
+template <class ENC_CTX, class ERR_POLICY, class... VARIABLE>
+class skeleton_recorder : public octet_encoder<ENC_CTX, ERR_POLICY>
+{
+	using base_t = octet_encoder<ENC_CTX, ERR_POLICY>;
+
+public:
+	static constexpr bool keeps_snapshots = true;
+	static constexpr std::size_t num_vars = sizeof...(VARIABLE);
+	static constexpr std::size_t max_lens = 16 * num_vars;
+
+	using typename base_t::state_type;
+	using base_t::base_t;
+	using base_t::operator();
+
+	void operator() (SET_STATE, state_type const& st)
+	{
+		auto const before = offset();
+		m_frontier = std::max(m_frontier, before);
+		base_t::operator()(SET_STATE{}, st);
+		//going back to write the length (possibly after its preceding fields)
+		if (offset() < before) { m_patch_start = offset(); }
+	}
+
+	void operator() (SNAPSHOT ss)
+	{
+		std::size_t i = 0;
+		((ss.id == snapshot_id<VARIABLE> && m_vars[i].pos == skeleton_var::npos
+			? void(m_vars[i] = {offset(), ss.size}) : void(), ++i), ...);
+	}
+
+	template <class IE> void operator() (IE const& ie, IE_LEN)
+	{
+		if (offset() < m_frontier) { backpatched(ie); }
+		else { ++m_pending; } //placeholder or length known beforehand
+		base_t::operator()(ie, IE_LEN{});
+	}
+
+	//explicit length written back by its offset in container
+	template <class IE> void operator() (IE const& ie, IE_VALUE)
+	{
+		if (offset() < m_frontier) { backpatched(ie, false); }
+		base_t::operator()(ie, IE_VALUE{});
+	}
+
+	//lengths which weren't written back can't be patched
+	bool all_backpatched() const                    { return m_pending == 0; }
+	std::array<skeleton_var, num_vars> const& vars() const { return m_vars; }
+	std::span<skeleton_len const> lens() const      { return {m_lens.data(), m_num_lens}; }
+
+private:
+	std::size_t offset()                            { return this->get_context().buffer().get_offset(); }
+
+	template <class IE>
+	void backpatched(IE const& ie, bool implicit = true)
+	{
+		if (implicit) { --m_pending; }
+
+		std::uint64_t vars = 0;
+		for (std::size_t i = 0; i < num_vars; ++i)
+		{
+			auto const ofs = m_vars[i].pos;
+			if (ofs != skeleton_var::npos && ofs >= m_patch_start && ofs < m_frontier) { vars |= std::uint64_t{1} << i; }
+		}
+		if (!vars) { return; }
+
+		using traits = typename IE::traits;
+		constexpr bool patchable = !AHasSetLength<IE> && std::is_void_v<typename get_padding<IE>::type>
+			&& traits::offset == 0 && (traits::bits % 8) == 0 && traits::bits <= 64;
+		if (patchable && m_num_lens < max_lens)
+		{
+			m_lens[m_num_lens++] = {offset(), std::size_t(ie.get_encoded()), vars, uint8_t(traits::bits / 8)};
+		}
+		else
+		{
+			for (std::size_t i = 0; i < num_vars; ++i)
+			{
+				if (vars & (std::uint64_t{1} << i)) { m_vars[i].resizable = false; }
+			}
+		}
+	}
+
+	std::array<skeleton_var, num_vars> m_vars;
+	std::array<skeleton_len, max_lens> m_lens;
+	std::size_t m_num_lens{0};
+	std::size_t m_frontier{0};
+	std::size_t m_patch_start{0};
+	std::size_t m_pending{0};
+};
+
+} //end: namespace detail
+
+/**
+ * Message encoded once into a byte skeleton to emit its copies cheaply
+ * @details The VARIABLE IEs (marked with_snapshot) are recorded by their
+ * offsets in the skeleton. Each emit copies the skeleton and encodes only
+ * the new values of VARIABLE IEs in place. If a variable IE changes its size
+ * (e.g. octet string) the rest is shifted and the lengths enclosing it are
+ * patched provided they were written back by the encoder as plain values.
+ * NOTE: only the 1st occurrence of each VARIABLE IE in message is recorded.
+ */
+template <class MSG, std::size_t CAPACITY, class... VARIABLE>
+class skeleton
+{
+	static_assert(sizeof...(VARIABLE) > 0 && sizeof...(VARIABLE) <= 64, "1..64 VARIABLE IEs EXPECTED");
+	static_assert((std::is_base_of_v<with_snapshot, VARIABLE> && ...), "IEs WITH med::with_snapshot ARE EXPECTED");
+
+public:
+	static constexpr std::size_t num_vars = sizeof...(VARIABLE);
+
+	/**
+	 * Encodes the message as skeleton
+	 * @details all VARIABLE IEs must be present in the message
+	 * @return status when errors are reported w/o exceptions (skeleton is empty on error)
+	 */
+	template <class ERR_POLICY = default_error_policy>
+	auto prepare(MSG const& msg, ERR_POLICY = {})
+	{
+		encoder_context<> ctx{m_bytes};
+		detail::skeleton_recorder<encoder_context<>, ERR_POLICY, VARIABLE...> recorder{ctx};
+		m_size = 0;
+		encode(recorder, msg);
+		if (not has_failed(recorder)) { record(recorder, ctx.buffer().get_offset()); }
+		if constexpr (requires { recorder.status(); }) { return recorder.status(); }
+	}
+
+	std::span<uint8_t const> bytes() const          { return {m_bytes, m_size}; }
+	std::size_t size() const                        { return m_size; }
+
+	/**
+	 * Emits the message into the encoder's buffer
+	 * @param encoder octet encoder to write with
+	 * @param vars new values of VARIABLE IEs
+	 */
+	template <class ENCODER>
+	void emit(ENCODER&& encoder, VARIABLE const&... vars)
+	{
+		//change of size for each variable IE
+		std::ptrdiff_t delta[num_vars] = {};
+		{
+			std::size_t i = 0;
+			if (not (resize(encoder, vars, i++, delta) && ...)) { return; }
+		}
+		std::size_t total = m_size;
+		for (auto const d : delta) { total += d; }
+
+		auto const start = encoder(GET_STATE{});
+		uint8_t* out = encoder.get_context().buffer().template advance<MSG>(int(total), encoder);
+		if (!out) { return; }
+
+		//copy constant parts
+		std::size_t dst_of[num_vars];
+		std::size_t src = 0, dst = 0;
+		for (auto const i : m_order)
+		{
+			auto const& v = m_vars[i];
+			std::memcpy(out + dst, m_bytes + src, v.pos - src);
+			dst += v.pos - src;
+			dst_of[i] = dst;
+			dst += v.size + delta[i];
+			src = v.pos + v.size;
+		}
+		std::memcpy(out + dst, m_bytes + src, m_size - src);
+
+		//patch lengths
+		for (std::size_t k = 0; k < m_num_lens; ++k)
+		{
+			auto const& len = m_lens[k];
+			std::size_t value = len.value;
+			std::size_t shift = 0;
+			for (std::size_t i = 0; i < num_vars; ++i)
+			{
+				if (len.vars & (std::uint64_t{1} << i)) { value += delta[i]; }
+				else if (m_vars[i].pos < len.pos) { shift += delta[i]; } //preceding IE
+			}
+			if (len.width < sizeof(value) && (value >> (8 * len.width)))
+			{
+				MED_RETURN_ERROR(encoder, invalid_value, name<MSG>(), value, encoder.get_context().buffer())
+			}
+			for (auto* p = out + len.pos + shift, *end = p + len.width; p != end; ++p)
+			{
+				*p = uint8_t(value >> (8 * (end - p - 1)));
+			}
+		}
+
+		//encode variable IEs in place
+		std::size_t i = 0;
+		((encoder(SET_STATE{}, start), encoder(ADVANCE_STATE{int(dst_of[i++])}), encode(encoder, vars)), ...);
+		encoder(SET_STATE{}, start);
+		encoder(ADVANCE_STATE{int(total)});
+	}
+
+private:
+	template <class RECORDER>
+	void record(RECORDER& recorder, std::size_t encoded)
+	{
+		m_vars = recorder.vars();
+		auto const lens = recorder.lens();
+		m_num_lens = lens.size();
+		std::copy(lens.begin(), lens.end(), m_lens.begin());
+
+		std::size_t i = 0;
+		if (not (check_recorded<VARIABLE>(recorder, i++) && ...)) { return; }
+		if (not recorder.all_backpatched())
+		{
+			for (auto& v : m_vars) { v.resizable = false; }
+		}
+
+		for (std::size_t k = 0; k < num_vars; ++k) { m_order[k] = k; }
+		std::sort(m_order.begin(), m_order.end(), [this](auto a, auto b) { return m_vars[a].pos < m_vars[b].pos; });
+		m_size = encoded;
+	}
+
+	template <class IE, class RECORDER>
+	bool check_recorded(RECORDER& recorder, std::size_t i) const
+	{
+		if (m_vars[i].pos != detail::skeleton_var::npos) { return true; }
+		raise_error<missing_ie>(recorder, name<IE>(), 1, 0);
+		return false;
+	}
+
+	template <class ENCODER, class IE>
+	bool resize(ENCODER& encoder, IE const& ie, std::size_t i, std::ptrdiff_t (&delta)[num_vars]) const
+	{
+		auto const len = sl::ie_length<type_context<typename IE::ie_type>>(ie, encoder);
+		delta[i] = std::ptrdiff_t(len) - std::ptrdiff_t(m_vars[i].size);
+		if (delta[i] && not m_vars[i].resizable)
+		{
+			raise_error<invalid_value>(encoder, name<IE>(), len, encoder.get_context().buffer());
+			return false;
+		}
+		return true;
+	}
+
+	uint8_t                                     m_bytes[CAPACITY];
+	std::size_t                                 m_size{0};
+	std::array<detail::skeleton_var, num_vars>  m_vars;
+	std::array<std::size_t, num_vars>           m_order;
+	std::array<detail::skeleton_len, 16 * num_vars> m_lens;
+	std::size_t                                 m_num_lens{0};
+};
+
+}	//end: namespace med
@@ -21,6 +21,11 @@ constexpr void field_copy(IE& to, IE const& from, ARGS&&... args)
 		if constexpr (AMultiField<IE>)
 		{
 			to.clear();
+			//external storage for all fields in single allocation
+			if constexpr (sizeof...(ARGS) > 0)
+			{
+				if (!to.reserve(from.count(), args...)) { return; }
+			}
 			for (auto const& rhs : from)
 			{
 				auto* p = to.push_back(std::forward<ARGS>(args)...);
@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+@file
+fixed layout of mandatory byte-aligned values encoded/decoded at once
+
+@copyright Denis Priyomov 2016-2018
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+#include "../bytes.hpp"
+#include "../concepts.hpp"
+#include "../ie_type.hpp"
+#include "../snapshot.hpp"
+#include "../meta/typelist.hpp"
+
+namespace med::sl {
+
+//codec operation on fixed layout of values in a container
+template <class IE_LIST>
+struct FIXED_LAYOUT {};
+
+//mandatory single byte-aligned value w/o meta-info
+template <class CODEC, class IE>
+constexpr bool is_fixed_value()
+{
+	if constexpr (AMandatory<IE> && !AMultiField<IE> && !AHasSetterType<IE> && !std::is_base_of_v<with_snapshot, IE>)
+	{
+		using field_t = get_field_type_t<IE>;
+		if constexpr (std::is_same_v<IE_VALUE, typename field_t::ie_type>
+			&& meta::list_is_empty_v<meta::produce_info_t<CODEC, IE>>)
+		{
+			return field_t::traits::offset == 0 && (field_t::traits::bits % 8) == 0 && field_t::traits::bits <= 64;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+}
+
+/**
+ * Layout of adjacent values packed into words of up to 8 octets
+ * @details each word is read/written by single wide byte-swapped access
+ */
+template <class IE_LIST>
+struct fixed_layout;
+
+template <template <class...> class L, class... IEs>
+struct fixed_layout<L<IEs...>>
+{
+	static constexpr std::size_t num_fields = sizeof...(IEs);
+	static constexpr std::size_t size = (std::size_t{0} + ... + (get_field_type_t<IEs>::traits::bits / 8));
+
+	struct plan_t
+	{
+		std::array<std::size_t, num_fields> word;  //index of field's word
+		std::array<std::size_t, num_fields> shift; //of field in its word in bits
+		std::array<std::size_t, num_fields> offset; //of word in octets
+		std::array<std::size_t, num_fields> octets; //size of word
+	};
+
+	static constexpr plan_t plan = []
+	{
+		std::size_t const sizes[] = {(get_field_type_t<IEs>::traits::bits / 8)...};
+		std::size_t ends[num_fields] = {};
+		plan_t p{};
+		std::size_t ofs = 0, w = 0;
+		for (std::size_t i = 0; i < num_fields; ++i)
+		{
+			if (p.octets[w] + sizes[i] > 8) { ++w; }
+			if (p.octets[w] == 0) { p.offset[w] = ofs; }
+			p.word[i] = w;
+			p.octets[w] += sizes[i];
+			ofs += sizes[i];
+			ends[i] = ofs;
+		}
+		for (std::size_t i = 0; i < num_fields; ++i)
+		{
+			auto const k = p.word[i];
+			p.shift[i] = 8 * (p.offset[k] + p.octets[k] - ends[i]);
+		}
+		return p;
+	}();
+	static constexpr std::size_t num_words = plan.word[num_fields - 1] + 1;
+
+	template <class IES>
+	static constexpr bool is_set(IES const& ies)
+	{
+		return (static_cast<IEs const&>(ies).is_set() && ...);
+	}
+
+	template <class IES>
+	static constexpr void put(uint8_t* out, IES const& ies)
+	{
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			std::size_t words[num_words] = {};
+			((words[plan.word[Is]] |= (std::size_t(static_cast<IEs const&>(ies).get_encoded()) & mask<IEs>()) << plan.shift[Is]), ...);
+			[&]<std::size_t... Ws>(std::index_sequence<Ws...>)
+			{
+				(put_bytes<plan.octets[Ws]>(words[Ws], out + plan.offset[Ws]), ...);
+			}(std::make_index_sequence<num_words>{});
+		}(std::make_index_sequence<num_fields>{});
+	}
+
+	//returns false if a field has invalid value
+	template <class IES>
+	static constexpr bool get(uint8_t const* in, IES& ies)
+	{
+		return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			std::size_t words[num_words];
+			[&]<std::size_t... Ws>(std::index_sequence<Ws...>)
+			{
+				((words[Ws] = get_bytes<plan.octets[Ws]>(in + plan.offset[Ws])), ...);
+			}(std::make_index_sequence<num_words>{});
+
+			return (set_field<Is, IEs>(words[plan.word[Is]], ies) && ...);
+		}(std::make_index_sequence<num_fields>{});
+	}
+
+private:
+	template <class IE>
+	static constexpr std::size_t mask()
+	{
+		constexpr auto BITS = get_field_type_t<IE>::traits::bits;
+		if constexpr (BITS < 64) { return (std::size_t{1} << BITS) - 1; }
+		else { return ~std::size_t{0}; }
+	}
+
+	template <std::size_t I, class IE, class IES>
+	static constexpr bool set_field(std::size_t word, IES& ies)
+	{
+		using value_t = typename get_field_type_t<IE>::value_type;
+		auto const val = value_t((word >> plan.shift[I]) & mask<IE>());
+		IE& ie = ies;
+		if constexpr (std::is_same_v<bool, decltype(ie.set_encoded(val))>)
+		{
+			return ie.set_encoded(val);
+		}
+		else
+		{
+			ie.set_encoded(val);
+			return true;
+		}
+	}
+};
+
+//all fields are fixed values (worth for 2+ fields only)
+template <class CODEC, class IE_LIST>
+struct is_fixed_layout : std::false_type {};
+template <class CODEC, template <class...> class L, class... IEs>
+struct is_fixed_layout<CODEC, L<IEs...>>
+	: std::bool_constant<(sizeof...(IEs) > 1) && (is_fixed_value<CODEC, IEs>() && ...)> {};
+
+//fields of container having fixed layout supported by the codec
+template <class CODEC, class IE_LIST, class IES>
+concept AFixedLayout = is_fixed_layout<CODEC, IE_LIST>::value
+	&& requires(CODEC& c, IES& ies) { { c(FIXED_LAYOUT<IE_LIST>{}, ies) } -> std::same_as<bool>; };
+
+} //namespace med::sl
@@ -0,0 +1,144 @@
+/**
+@file
+skipping of encoded IE w/o decoding its value
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include "../decode.hpp"
+#include "../padding.hpp"
+#include "../concepts.hpp"
+
+namespace med::sl {
+
+enum class skip_kind
+{
+	EAGER,    //can't skip w/o decoding
+	FIXED,    //<TV> of fixed size
+	LENGTH,   //<TLV>
+	EXPLICIT, //<T[LV]> with the length as the 1st field of the value
+};
+
+//how IE of a set can be skipped w/o decoding its value
+template <class IE, class DECODER>
+constexpr skip_kind get_skip_kind()
+{
+	using mi = meta::produce_info_t<DECODER, IE>;
+	using tag_t = get_info_t<meta::list_first_t<mi>>;
+	using mi_rest = meta::list_rest_t<mi>;
+	using field_t = get_field_type_t<IE>;
+	constexpr bool fixed_tag = APredefinedValue<tag_t>;
+
+	if constexpr (meta::list_is_empty_v<mi_rest>)
+	{
+		if constexpr (fixed_tag && !AContainer<field_t> && !AHasSize<field_t> && requires { field_t::traits::bits; })
+		{
+			return (field_t::traits::bits % 8) ? skip_kind::EAGER : skip_kind::FIXED;
+		}
+		else
+		{
+			return skip_kind::EAGER;
+		}
+	}
+	else if constexpr (meta::list_first_t<mi_rest>::kind != mik::LEN)
+	{
+		return skip_kind::EAGER;
+	}
+	else
+	{
+		using len_t = get_info_t<meta::list_first_t<mi_rest>>;
+		if constexpr (!std::is_void_v<get_dependency_t<len_t>>)
+		{
+			return skip_kind::EAGER;
+		}
+		else if constexpr (!APresentIn<len_t, field_t>)
+		{
+			return fixed_tag ? skip_kind::LENGTH : skip_kind::EAGER;
+		}
+		else
+		{
+			//the length has to be right after the tag
+			using first_t = get_field_type_t<meta::list_first_t<typename field_t::ies_types>>;
+			if constexpr (fixed_tag && std::is_same_v<first_t, len_t>)
+			{
+				return skip_kind::EXPLICIT;
+			}
+			else if constexpr (!fixed_tag && std::is_same_v<first_t, tag_t>
+				&& meta::list_size_v<typename field_t::ies_types> > 1)
+			{
+				using second_t = get_field_type_t<meta::list_first_t<meta::list_rest_t<typename field_t::ies_types>>>;
+				return std::is_same_v<second_t, len_t> ? skip_kind::EXPLICIT : skip_kind::EAGER;
+			}
+			else
+			{
+				return skip_kind::EAGER;
+			}
+		}
+	}
+}
+
+//skips the value of IE which tag was already decoded
+template <class IE, skip_kind KIND, class DECODER, class STATE>
+constexpr void skip_value(DECODER& decoder, STATE const& ie_start)
+{
+	using mi = meta::produce_info_t<DECODER, IE>;
+	using mi_rest = meta::list_rest_t<mi>;
+	if constexpr (KIND == skip_kind::FIXED)
+	{
+		decoder(ADVANCE_STATE{int(bits_to_bytes(get_field_type_t<IE>::traits::bits))});
+	}
+	else
+	{
+		using len_t = get_info_t<meta::list_first_t<mi_rest>>;
+		using pad_traits = typename get_padding<len_t>::type;
+		//padding is counted from the length for TLV and from IE start otherwise
+		using tag_t = get_info_t<meta::list_first_t<mi>>;
+		auto const pad_start = APredefinedValue<tag_t> ? decoder(GET_STATE{}) : ie_start;
+		auto const len = decode_len<len_t>(decoder);
+		if (has_failed(decoder)) { return; }
+		//huge length would wrap when advancing by int
+		if (std::size_t(len) > decoder.get_context().buffer().size())
+		{
+			MED_RETURN_ERROR(decoder, overflow, name<IE>(), std::size_t(len), decoder.get_context().buffer())
+		}
+		decoder(ADVANCE_STATE{int(len)});
+		if constexpr (!std::is_void_v<pad_traits>)
+		{
+			if (has_failed(decoder)) { return; }
+			using pad_t = typename DECODER::template padder_type<pad_traits, DECODER>;
+			std::size_t padded = len;
+			if constexpr (KIND == skip_kind::EXPLICIT) { padded = std::size_t(decoder(GET_STATE{}) - pad_start); }
+			if (auto const pad_size = pad_t::calc_padding_size(padded))
+			{
+				decoder(ADD_PADDING{uint8_t(pad_size), pad_traits::filler});
+			}
+		}
+	}
+}
+
+//skips IE of a set which tag was already decoded (decodes it if can't skip)
+template <class IE, class DECODER, class STATE>
+constexpr void skip_ie(DECODER& decoder, STATE const& ie_start)
+{
+	constexpr auto kind = get_skip_kind<IE, DECODER>();
+	if constexpr (kind == skip_kind::EAGER)
+	{
+		using mi = meta::produce_info_t<DECODER, IE>;
+		using tag_t = get_info_t<meta::list_first_t<mi>>;
+		if constexpr (!APredefinedValue<tag_t>) { decoder(POP_STATE{}); }
+		CODEC_TRACE("skip by decoding [%s]", name<IE>());
+		get_field_type_t<IE> ie;
+		ie_decode<type_context<IE_SET, meta::list_rest_t<mi>>>(decoder, ie);
+	}
+	else
+	{
+		CODEC_TRACE("skip [%s]", name<IE>());
+		skip_value<IE, kind>(decoder, ie_start);
+	}
+}
+
+}	//end: namespace med::sl
@@ -9,6 +9,7 @@ Distributed under the MIT License
 
 #pragma once
 
+#include "allocator.hpp"
 #include "length.hpp"
 #include "state.hpp"
 
@@ -19,6 +20,41 @@ namespace med {
 //NOTE: requires IE to have name() defined!
 struct with_snapshot {};
 
+//encoder takes snapshots when it has allocator to store them or records them itself
+template <class ENCODER>
+constexpr bool keeps_snapshots()
+{
+	if constexpr (requires { requires ENCODER::keeps_snapshots; })
+	{
+		return true;
+	}
+	else
+	{
+		return !std::is_same_v<null_allocator, std::remove_const_t<typename ENCODER::allocator_type>>;
+	}
+}
+
+//IE itself or any of its nested fields takes snapshot
+template <class IE>
+constexpr bool holds_snapshot()
+{
+	if constexpr (std::is_base_of_v<with_snapshot, IE>)
+	{
+		return true;
+	}
+	else if constexpr (requires { typename IE::ies_types; })
+	{
+		return []<class... FIELDS>(meta::typelist<FIELDS...>)
+		{
+			return (holds_snapshot<get_field_type_t<FIELDS>>() || ...);
+		}(typename IE::ies_types{});
+	}
+	else
+	{
+		return false;
+	}
+}
+
 template <class FUNC, class IE>
 constexpr void put_snapshot(FUNC& func, IE& ie)
 {
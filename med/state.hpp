@@ -47,6 +47,13 @@ struct ADD_PADDING
 };
 
 
+//Copy octets encoded before by the same codec (e.g. unmodified part of decoded message).
+struct COPY_OCTETS
+{
+	uint8_t const* data;
+	std::size_t    size;
+};
+
 //Save current buffer state referred by id.
 //It's similar to PUSH_STATE but saved in optional storage provided by user
 //and associated with identifier for later retrieval.
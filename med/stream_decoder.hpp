@@ -0,0 +1,156 @@
+/**
+@file
+decoding of message received in fragments (e.g. over TCP)
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "exception.hpp"
+#include "decode.hpp"
+#include "octet_decoder.hpp"
+
+namespace med {
+
+/**
+ * Error policy to tell truncated input from malformed one.
+ * @details Overflow outside of any length scope means the data just ended
+ * thus the number of missing octets is recorded.
+ */
+class stream_on_error : public status_on_error
+{
+public:
+	constexpr std::size_t need() const noexcept        { return m_need; }
+	constexpr void reset_status() noexcept             { status_on_error::reset_status(); m_need = 0; }
+
+	template <class EX, class... ARGS>
+	constexpr void on_error(char const* name, std::size_t v1, ARGS const&... args) noexcept
+	{
+		if constexpr (std::is_same_v<EX, overflow> && sizeof...(ARGS) == 1)
+		{
+			if (not failed()) { m_need = missing(v1, args...); }
+		}
+		status_on_error::template on_error<EX>(name, v1, args...);
+	}
+
+private:
+	template <class BUFFER>
+	static constexpr std::size_t missing(std::size_t bytes, BUFFER const& buf) noexcept
+	{
+		if constexpr (requires { buf.depth(); })
+		{
+			constexpr auto MAX_BYTES = std::size_t(std::numeric_limits<std::ptrdiff_t>::max());
+			if (0 == buf.depth() && bytes > buf.size() && bytes <= MAX_BYTES) { return bytes - buf.size(); }
+		}
+		return 0;
+	}
+
+	std::size_t m_need{0};
+};
+
+//progress of decoding in stream
+enum class progress : uint8_t
+{
+	done,      //message is decoded
+	need_more, //more data needed to decode
+	failed,    //message is malformed
+};
+
+/**
+ * Retrying decoder of message received in fragments directly from the
+ * receive buffer.
+ * @details The fragments are expected to be appended contiguously after
+ * each other. When the data ends the decoder reports how many octets are
+ * still missing (exact for messages framed with outer length) and does not
+ * attempt to decode until these are received.
+ * Each attempt restarts from the 1st octet of the message and re-walks the
+ * data received so far thus with length-framed protocols (e.g. Diameter)
+ * the message is decoded in full only once.
+ * NOTE: the context allocator (if it can be released) is released before
+ * each retry to drop the storage of incomplete attempt so it must not hold
+ * anything else while the message is decoded.
+ */
+template <class DEC_CTX, template <class, class> class DECODER = octet_decoder>
+class stream_decoder
+{
+public:
+	using decoder_type = DECODER<DEC_CTX, stream_on_error>;
+
+	explicit stream_decoder(DEC_CTX& ctx) noexcept : m_ctx{ctx} { }
+
+	/**
+	 * Starts new message
+	 * @param data start of receive buffer
+	 * @param size number of octets already received
+	 */
+	constexpr void reset(void const* data, std::size_t size = 0) noexcept
+	{
+		m_start = data;
+		m_size = size;
+		m_expect = 0;
+		m_attempts = 0;
+		m_status.reset();
+	}
+
+	/**
+	 * Accounts more octets received right after previous ones
+	 * @param size number of octets received
+	 */
+	constexpr void append(std::size_t size) noexcept   { m_size += size; }
+
+	template <class IE>
+	progress decode(IE& ie)
+	{
+		if (m_size < m_expect) { return progress::need_more; }
+
+		if (m_attempts++)
+		{
+			ie.clear();
+			if constexpr (requires { m_ctx.get_allocator().release(); }) { m_ctx.get_allocator().release(); }
+		}
+		m_ctx.reset(m_start, m_size);
+		decoder_type decoder{m_ctx};
+		med::decode(decoder, ie);
+		m_status = decoder.status();
+
+		if (not decoder.failed())
+		{
+			m_expect = 0;
+			return progress::done;
+		}
+		if (auto const need = decoder.need())
+		{
+			m_expect = m_size + need;
+			CODEC_TRACE("need %zu more octets after %zu", need, m_size);
+			return progress::need_more;
+		}
+		return progress::failed;
+	}
+
+	//number of octets still missing to complete the message (may be a lower bound)
+	constexpr std::size_t needed() const noexcept      { return m_expect > m_size ? m_expect - m_size : 0; }
+	//number of octets received so far
+	constexpr std::size_t size() const noexcept        { return m_size; }
+	//number of octets consumed by decoded message
+	constexpr std::size_t consumed() noexcept          { return m_ctx.buffer().get_offset(); }
+	//number of decode attempts for the current message
+	constexpr std::size_t attempts() const noexcept    { return m_attempts; }
+	//status of the last attempt
+	constexpr med::status const& status() const noexcept { return m_status; }
+
+private:
+	DEC_CTX&     m_ctx;
+	void const*  m_start{nullptr};
+	std::size_t  m_size{0};
+	std::size_t  m_expect{0};
+	std::size_t  m_attempts{0};
+	med::status  m_status;
+};
+
+}	//end: namespace med
@@ -9,11 +9,16 @@ Distributed under the MIT License
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <type_traits>
 
 #include "ie_type.hpp"
+#include "traits.hpp"
 #include "meta/typelist.hpp"
+#include "meta/foreach.hpp"
 #include "concepts.hpp"
+#include "debug.hpp"
 
 namespace med {
 
@@ -38,4 +43,152 @@ constexpr auto get_tag(T const& header)
 	}
 }
 
+namespace sl {
+
+/**
+ * Compile-time hash table of fixed tags of IEs (e.g. in set or choice)
+ * @details open addressing with linear probing in a table at least twice
+ * as large as number of IEs so lookup is constant on average.
+ * IEs with non-fixed tags or fixed ones with overridden match are not in
+ * the table.
+ */
+template <class FUNC, class... IEs>
+struct tag_table
+{
+	template <class IE>
+	using mi_t = meta::list_first_t<meta::produce_info_t<FUNC, IE>>;
+
+	template <class IE>
+	static constexpr bool is_fixed()
+	{
+		if constexpr (mi_t<IE>::kind == mik::TAG) { return has_plain_match<get_info_t<mi_t<IE>>>(); }
+		else { return false; }
+	}
+
+	//fixed tag w/o overridden match
+	template <class TAG>
+	static constexpr bool has_plain_match()
+	{
+		if constexpr (APredefinedValue<TAG>) { return &TAG::match == &TAG::base_t::match; }
+		else { return false; }
+	}
+
+	static constexpr std::size_t num_ies = sizeof...(IEs);
+	static constexpr std::size_t not_found = num_ies;
+	static constexpr bool fixed[] = { is_fixed<IEs>()... };
+
+	//index of 1st IE with non-fixed tag which can't be found in the table
+	static constexpr std::size_t first_unfixed = []
+	{
+		std::size_t i = 0;
+		while (i < num_ies && fixed[i]) { ++i; }
+		return i;
+	}();
+
+	static constexpr std::size_t num_slots = []
+	{
+		std::size_t n = 2;
+		while (n < 2 * num_ies) { n <<= 1; }
+		return n;
+	}();
+
+	static constexpr std::size_t hash(std::size_t tag) noexcept
+	{
+		return std::size_t((uint64_t(tag) * 0x9E3779B97F4A7C15ull) >> 32) & (num_slots - 1);
+	}
+
+	template <class IE>
+	static constexpr std::size_t tag_of()
+	{
+		if constexpr (is_fixed<IE>()) { return std::size_t(get_info_t<mi_t<IE>>::get_encoded()); }
+		else { return 0; }
+	}
+
+	struct slot
+	{
+		std::size_t tag;
+		std::size_t index;
+	};
+
+	static constexpr auto slots = []
+	{
+		std::array<slot, num_slots> res{};
+		for (auto& s : res) { s.index = not_found; }
+		constexpr std::size_t tags[] = { tag_of<IEs>()... };
+		for (std::size_t i = 0; i < num_ies; ++i)
+		{
+			if (not fixed[i]) { continue; }
+			auto pos = hash(tags[i]);
+			while (res[pos].index != not_found) { pos = (pos + 1) & (num_slots - 1); }
+			res[pos] = slot{tags[i], i};
+		}
+		return res;
+	}();
+
+	//@return index of IE with the tag or not_found
+	static constexpr std::size_t find(std::size_t tag) noexcept
+	{
+		for (auto pos = hash(tag); slots[pos].index != not_found; pos = (pos + 1) & (num_slots - 1))
+		{
+			if (slots[pos].tag == tag) { return slots[pos].index; }
+		}
+		return not_found;
+	}
+
+	//applies functor to IE by its index
+	template <class F, class... Args>
+	static constexpr auto apply(std::size_t index, F& f, Args&... args)
+	{
+		using ret_type = decltype(f.apply(args...));
+		using fn_type = ret_type (*)(F&, Args&...);
+		constexpr fn_type fns[] = { [](F& fn, Args&... as) -> ret_type { return fn.template apply<IEs>(as...); }... };
+		return fns[index](f, args...);
+	}
+};
+
+template <class FUNC, class IE_LIST> struct tag_dispatch;
+template <class FUNC, template<class...> class L, class... IEs>
+struct tag_dispatch<FUNC, L<IEs...>>
+{
+	using table = tag_table<FUNC, IEs...>;
+
+	template <class F, class... Args>
+	static constexpr auto exec(std::size_t tag, F& f, Args&... args)
+	{
+		if constexpr (table::first_unfixed > 0)
+		{
+			if (auto const index = table::find(tag); index < table::first_unfixed)
+			{
+				CODEC_TRACE("tag=%#zX found at %zu", tag, index);
+				return table::apply(index, f, args...);
+			}
+			if constexpr (table::first_unfixed == table::num_ies)
+			{
+				return f.apply(args...);
+			}
+		}
+		if constexpr (table::first_unfixed < table::num_ies)
+		{
+			return meta::for_if<L<IEs...>>(f, args...);
+		}
+	}
+};
+
+/**
+ * Applies functor to IE with the tag (same as meta::for_if with tag matching check)
+ * @details IE is looked up in compile-time table if its tag is fixed and no IE
+ * with non-fixed tag precedes it, otherwise the IEs are checked one by one.
+ * @tparam IE_LIST IEs to look in
+ * @tparam FUNC codec for meta-information of the IEs
+ * @param tag value of the tag
+ * @param f functor to apply (its apply w/o IE is called if none found)
+ */
+template <class IE_LIST, class FUNC, class F, class... Args>
+constexpr auto for_tag(std::size_t tag, F&& f, Args&&... args)
+{
+	return tag_dispatch<FUNC, IE_LIST>::exec(tag, f, args...);
+}
+
+}	//end: namespace sl
+
 }	//end: namespace med
@@ -0,0 +1,115 @@
+/**
+@file
+container tracking its modifications since decoding for incremental re-encode
+
+@copyright Denis Priyomov 2016-2017
+Distributed under the MIT License
+(See accompanying file LICENSE or visit https://github.com/cppden/med)
+*/
+
+#pragma once
+
+#include <span>
+#include <type_traits>
+
+#include "exception.hpp"
+#include "snapshot.hpp"
+#include "state.hpp"
+#include "sl/octet_info.hpp"
+
+namespace med {
+
+/**
+ * Container (sequence or set) remembering its encoded origin in the input
+ * @details The decoded container refers to its octets in the input buffer
+ * until it's modified via ref/clear/copy. Encoding the unmodified container
+ * copies these octets as is while the modified one is encoded field by field
+ * so the enclosing lengths are written anew. Nested tracked containers which
+ * weren't modified are copied in turn thus only the dirty subtrees are
+ * re-encoded. The container holding IEs with_snapshot is encoded field by
+ * field when the encoder keeps snapshots.
+ * NOTE: the input buffer must outlive the decoded message.
+ * NOTE: only ref/clear/copy of the tracked container mark it modified, so
+ * modify the nested fields (e.g. push_back to a multi-field or a field of
+ * nested non-tracked container) via ref from the top to mark all enclosing.
+ * A reference to nested field kept since before the decode bypasses this
+ * thus writing through it leaves stale octets to be copied on encode.
+ * Usage: struct MSG : med::tracked<med::sequence<...>> {};
+ */
+template <class CONTAINER>
+class tracked : public CONTAINER
+{
+public:
+	using CONTAINER::encode;
+	using CONTAINER::decode;
+
+	template <class FIELD>
+	decltype(auto) ref()
+	{
+		touch();
+		return CONTAINER::template ref<FIELD>();
+	}
+
+	template <class FIELD>
+	void clear()                            { touch(); CONTAINER::template clear<FIELD>(); }
+	void clear()                            { m_origin = {}; m_modified = false; CONTAINER::clear(); }
+
+	//the copy doesn't refer to the input of its source
+	template <class FROM, class... ARGS>
+	void copy(FROM const& from, ARGS&&... args)
+	{
+		touch();
+		CONTAINER::copy(from, std::forward<ARGS>(args)...);
+	}
+
+	//modified since decoded
+	bool modified() const                   { return m_modified; }
+	//encoded octets in the input which can be copied as is
+	std::span<uint8_t const> origin() const { return m_modified ? std::span<uint8_t const>{} : m_origin; }
+
+	void encode(auto& encoder) const
+	{
+		using encoder_t = std::remove_reference_t<decltype(encoder)>;
+		//snapshots are taken by encoding the fields
+		if constexpr (requires { encoder(COPY_OCTETS{}); }
+			&& not (keeps_snapshots<encoder_t>() && holds_snapshot<CONTAINER>()))
+		{
+			if (auto const octets = origin(); not octets.empty())
+			{
+				encoder(COPY_OCTETS{octets.data(), octets.size()});
+				return;
+			}
+		}
+		CONTAINER::encode(encoder);
+	}
+
+	void decode(auto& decoder, auto&... deps)
+	{
+		using decoder_t = std::remove_reference_t<decltype(decoder)>;
+		m_origin = {};
+		m_modified = false;
+		//octets of the same codec in contiguous input only
+		if constexpr (std::is_base_of_v<sl::octet_info, decoder_t>
+			&& not requires { decoder.get_context().buffer().template view<CONTAINER>(0, decoder); })
+		{
+			auto const* start = decoder.get_context().buffer().begin();
+			CONTAINER::decode(decoder, deps...);
+			if (not has_failed(decoder))
+			{
+				m_origin = {start, decoder.get_context().buffer().begin()};
+			}
+		}
+		else
+		{
+			CONTAINER::decode(decoder, deps...);
+		}
+	}
+
+private:
+	void touch()                            { m_origin = {}; m_modified = true; }
+
+	std::span<uint8_t const> m_origin;
+	bool                     m_modified{false};
+};
+
+} //end: namespace med
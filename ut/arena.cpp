@@ -0,0 +1,198 @@
+#include "ut.hpp"
+#include "arena.hpp"
+#include "pmr.hpp"
+#include "alloc_stats.hpp"
+
+namespace arn {
+
+struct U32 : med::value<uint32_t> {};
+
+struct MSG : med::sequence<
+	O< T<1>, U32, med::inf >
+>{};
+
+struct U16 : med::value<uint16_t> {};
+
+struct SEQ16 : med::sequence<
+	O< T<2>, U16, med::inf >
+>{
+	static constexpr char const* name() { return "SEQ16"; }
+};
+
+struct PROTO : med::choice<
+	M< T<0x10>, MSG >,
+	M< T<0x20>, SEQ16 >
+>{};
+
+} //end: namespace arn
+
+TEST(arena, allocate)
+{
+	med::arena arena{1024};
+	static_assert(med::AAllocator<med::arena>);
+
+	void* p1 = arena.allocate(100, 8);
+	ASSERT_NE(nullptr, p1);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 8);
+	EXPECT_EQ(1, arena.num_blocks());
+
+	//falls back to next block when exhausted
+	for (int i = 0; i < 100; ++i) { ASSERT_NE(nullptr, arena.allocate(100, 8)); }
+	auto const blocks = arena.num_blocks();
+	EXPECT_LT(1, blocks);
+
+	//bigger than block
+	ASSERT_NE(nullptr, arena.allocate(64 * 1024, 64));
+	EXPECT_EQ(blocks + 1, arena.num_blocks());
+
+	//blocks are reused after release
+	arena.release();
+	EXPECT_EQ(p1, arena.allocate(100, 8));
+	for (int i = 0; i < 100; ++i) { ASSERT_NE(nullptr, arena.allocate(100, 8)); }
+	EXPECT_EQ(blocks + 1, arena.num_blocks());
+}
+
+TEST(arena, pool)
+{
+	void* p = nullptr;
+	{
+		med::arena arena{1024};
+		p = arena.allocate(16, 8);
+		ASSERT_NE(nullptr, p);
+	}
+	//block is taken from thread-local pool
+	med::arena arena{1024};
+	EXPECT_EQ(p, arena.allocate(16, 8));
+}
+
+TEST(arena, pool_limit)
+{
+	med::arena::shrink_pool();
+	EXPECT_EQ(0, med::arena::pool_size());
+	auto const limit = med::arena::pool_limit();
+
+	//one block fits only
+	med::arena::pool_limit(4096);
+	{
+		med::arena arena{1024};
+		for (int i = 0; i < 10; ++i) { ASSERT_NE(nullptr, arena.allocate(512, 8)); }
+		EXPECT_LT(1, arena.num_blocks());
+	}
+	EXPECT_EQ(4096, med::arena::pool_size());
+
+	//excess is unmapped on lower limit
+	med::arena::pool_limit(0);
+	EXPECT_EQ(0, med::arena::pool_size());
+
+	med::arena::pool_limit(limit);
+	{
+		med::arena arena{1024};
+		ASSERT_NE(nullptr, arena.allocate(16, 8));
+	}
+	EXPECT_EQ(4096, med::arena::pool_size());
+	med::arena::shrink_pool();
+	EXPECT_EQ(0, med::arena::pool_size());
+}
+
+TEST(arena, huge_page)
+{
+	med::arena arena{1024, med::arena::pages::THP};
+	void* p = arena.allocate(16, 8);
+	ASSERT_NE(nullptr, p);
+	//block is mapped at huge page boundary
+	auto const block = reinterpret_cast<uintptr_t>(p) - sizeof(med::detail::arena_block);
+	EXPECT_EQ(0, block % med::arena::huge_page);
+	arena.free();
+	med::arena::shrink_pool();
+}
+
+TEST(arena, decode)
+{
+	uint8_t encoded[1 + 5 * 200];
+	for (std::size_t i = 0; i < 200; ++i)
+	{
+		uint8_t* p = encoded + i * 5;
+		p[0] = 1; p[1] = 0; p[2] = 0; p[3] = 0; p[4] = uint8_t(i);
+	}
+
+	med::arena arena{512};
+	med::decoder_context<med::arena> ctx{encoded, 5 * 200, &arena};
+	for (int round = 0; round < 3; ++round)
+	{
+		arn::MSG msg;
+		ctx.reset(encoded, 5 * 200);
+		decode(med::octet_decoder{ctx}, msg);
+		ASSERT_EQ(200, msg.count<arn::U32>());
+		EXPECT_EQ(199, msg.get<arn::U32>().last()->get());
+		arena.release();
+	}
+}
+
+TEST(pmr, allocator)
+{
+	uint8_t storage[512];
+	std::pmr::monotonic_buffer_resource res{storage, sizeof(storage), std::pmr::null_memory_resource()};
+	med::pmr_allocator alloc{&res};
+	static_assert(med::AAllocator<med::pmr_allocator>);
+
+	//multi-field storage from the resource
+	uint8_t const encoded[] = {1, 0, 0, 0, 1, 1, 0, 0, 0, 2, 1, 0, 0, 0, 3};
+	med::decoder_context<med::pmr_allocator> ctx{encoded, &alloc};
+	arn::MSG msg;
+	decode(med::octet_decoder{ctx}, msg);
+	ASSERT_EQ(3, msg.count<arn::U32>());
+	EXPECT_EQ(3, msg.get<arn::U32>().last()->get());
+
+	//no exception but nullptr when exhausted
+	EXPECT_EQ(nullptr, alloc.allocate(1024, 8));
+}
+
+TEST(pmr, memory_resource)
+{
+	med::arena arena{1024};
+	med::memory_resource res{arena};
+	std::pmr::vector<uint32_t> v{&res};
+	for (uint32_t i = 0; i < 100; ++i) { v.push_back(i); }
+	EXPECT_EQ(99, v.back());
+	EXPECT_LT(0, arena.num_blocks());
+
+	uint8_t storage[16];
+	med::allocator alloc{storage};
+	med::memory_resource small{alloc};
+	EXPECT_THROW((void)small.allocate(32, 8), std::bad_alloc);
+}
+
+TEST(arena, stats)
+{
+	med::arena arena{1024};
+	med::stats_allocator stats{arena};
+	med::decoder_context<med::stats_allocator<med::arena>> ctx{nullptr, 0, &stats};
+
+	uint8_t const msg_1[] = {0x10, 1, 0, 0, 0, 1};
+	uint8_t const msg_3[] = {0x10, 1, 0, 0, 0, 1, 1, 0, 0, 0, 2, 1, 0, 0, 0, 3};
+	uint8_t const seq16[] = {0x20, 2, 0, 1, 2, 0, 2};
+
+	arn::PROTO proto;
+	for (auto const& in : {std::span<uint8_t const>{msg_1}, std::span<uint8_t const>{msg_3}, std::span<uint8_t const>{seq16}})
+	{
+		ctx.reset(in.data(), in.size());
+		decode(med::octet_decoder{ctx}, proto);
+		stats.commit(proto);
+		arena.release();
+	}
+
+	EXPECT_EQ(2, stats.snapshot().size());
+	auto const* s = stats.find(med::name<arn::MSG>());
+	ASSERT_NE(nullptr, s);
+	EXPECT_EQ(2, s->messages);
+	EXPECT_EQ(1, s->allocations); //only 2nd and 3rd IEs go to external block
+	EXPECT_EQ(1, s->peak_count);
+	EXPECT_EQ(4 * sizeof(med::value<uint32_t>), s->peak_bytes);
+	EXPECT_EQ(1, s->histogram[0]);
+	EXPECT_EQ(1, s->histogram[med::alloc_stats::bucket(s->peak_bytes)]);
+
+	s = stats.find("SEQ16");
+	ASSERT_NE(nullptr, s);
+	EXPECT_EQ(1, s->messages);
+	EXPECT_EQ(1, s->peak_count);
+}
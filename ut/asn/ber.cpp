@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstring>
 
 #include "../ut.hpp"
 
@@ -6,7 +7,9 @@
 #include "asn/asn.hpp"
 #include "asn/ber/ber_length.hpp"
 #include "asn/ber/ber_encoder.hpp"
+#include "asn/ber/ber_reverse_encoder.hpp"
 #include "asn/ber/ber_decoder.hpp"
+#include "segmented_buffer.hpp"
 
 using namespace std::literals;
 
@@ -270,6 +273,19 @@ TEST(asn_ber, tag)
 	static_assert(tv32bit::value == 0b00011111'10001111'11111111'11111111'11111111'01111111);
 }
 
+//back-to-front encoder is expected to produce the same
+template <class IE>
+char const* check_reverse(IE const& ie, char const* expected)
+{
+	static uint8_t enc_buf[128*1024];
+	med::encoder_context<> ectx{ enc_buf };
+
+	med::asn::ber::reverse_encoder enc{ectx};
+	encode(enc, ie);
+	EXPECT_STREQ(expected, as_string(enc.encoded()));
+	return expected;
+}
+
 template <class IE> requires med::Arithmetic<typename IE::value_type>
 char const* encoded(typename IE::value_type const& val)
 {
@@ -286,7 +302,7 @@ char const* encoded(typename IE::value_type const& val)
 	decode(med::asn::ber::decoder{dctx}, dec);
 	EXPECT_EQ(enc.get(), dec.get());
 
-	return as_string(ectx.buffer());
+	return check_reverse(enc, as_string(ectx.buffer()));
 }
 
 template <class IE, typename T>
@@ -306,7 +322,7 @@ char const* encoded(T const* pval, std::size_t size)
 	EXPECT_EQ(enc.get().size(), dec.get().size());
 	//EXPECT_EQ(enc.get().data(), dec.get().data());
 
-	return as_string(ectx.buffer());
+	return check_reverse(enc, as_string(ectx.buffer()));
 }
 
 template <class IE>
@@ -324,7 +340,7 @@ char const* encoded(IE const& enc)
 	//EXPECT_EQ(enc.get().size(), dec.get().size());
 	//EXPECT_EQ(enc.get().data(), dec.get().data());
 
-	return as_string(ectx.buffer());
+	return check_reverse(enc, as_string(ectx.buffer()));
 }
 
 template <class IE>
@@ -341,7 +357,7 @@ char const* encoded()
 	dctx.reset(ectx.buffer().get_start(), ectx.buffer().get_offset());
 	decode(med::asn::ber::decoder{dctx}, dec);
 
-	return as_string(ectx.buffer());
+	return check_reverse(enc, as_string(ectx.buffer()));
 }
 
 
@@ -647,6 +663,94 @@ TEST(asn_ber, sequence)
 }
 #endif
 
+TEST(asn_ber, decode_status)
+{
+	auto decode_status = [](auto const& input)
+	{
+		ab::Seq s;
+		med::decoder_context<> ctx{ input };
+		return decode(med::asn::ber::decoder{ctx, med::status_on_error{}}, s);
+	};
+
+	uint8_t const ok[] = {0x30, 0x07, 0x80, 0x02, 0x12, 0x34, 0x82, 0x01, 0x07};
+	EXPECT_TRUE(decode_status(ok));
+
+	//no mint
+	{
+		uint8_t const missing[] = {0x31, 0x04, 0x80, 0x02, 0x12, 0x34};
+		ab::Set s;
+		med::decoder_context<> ctx{ missing };
+		EXPECT_EQ(med::error::missing_ie, decode(med::asn::ber::decoder{ctx, med::status_on_error{}}, s).code());
+	}
+
+	//sequence is longer than input
+	uint8_t const truncated[] = {0x30, 0x07, 0x80, 0x02, 0x12, 0x34, 0x82, 0x01};
+	EXPECT_EQ(med::error::overflow, decode_status(truncated).code());
+
+	//indefinite length form is not supported
+	uint8_t const bad_length[] = {0x30, 0x80, 0x80, 0x02, 0x12, 0x34, 0x82, 0x01, 0x07, 0, 0};
+	EXPECT_EQ(med::error::invalid_value, decode_status(bad_length).code());
+}
+
+TEST(asn_ber, decode_segmented)
+{
+	uint8_t const encoded[] = {0x30, 0x81, 0x0C, 0x80, 0x05, 'h', 'e', 'l', 'l', 'o', 0x82, 0x03, 0x01, 0x02, 0x03};
+	using ctx_t = med::decoder_context<med::null_allocator const, med::segmented_buffer<>>;
+
+	for (std::size_t chunk = 1; chunk <= sizeof(encoded); ++chunk)
+	{
+		//segments are apart in memory
+		uint8_t segments[sizeof(encoded)][sizeof(encoded) + 1];
+		std::memset(segments, 0xEE, sizeof(segments));
+		::iovec iov[sizeof(encoded)];
+		std::size_t num = 0;
+		for (std::size_t ofs = 0; ofs < sizeof(encoded); ofs += chunk, ++num)
+		{
+			auto const len = std::min(chunk, sizeof(encoded) - ofs);
+			std::memcpy(segments[num], encoded + ofs, len);
+			iov[num] = ::iovec{segments[num], len};
+		}
+
+		ctx_t ctx;
+		ctx.reset(std::span<::iovec const>{iov, num});
+		ab::Seq s;
+		decode(med::asn::ber::decoder{ctx}, s);
+		EXPECT_EQ("hello"sv, (std::string_view{(char const*)s.get<ab::moct>().data(), s.get<ab::moct>().size()})) << "chunk=" << chunk;
+		EXPECT_EQ(0x010203, s.get<ab::mint>().get()) << "chunk=" << chunk;
+		EXPECT_EQ(sizeof(encoded), ctx.buffer().get_offset());
+	}
+}
+
+//the length is known when it's encoded back-to-front
+TEST(asn_ber, reverse_long_length)
+{
+	std::vector<uint8_t> big;
+	for (std::size_t i = 0; i < 333; ++i) { big.push_back(uint8_t(i)); }
+
+	ab::Seq s;
+	s.ref<ab::moct>().set(big.size(), big.data());
+	s.ref<ab::mint>().set(7);
+
+	uint8_t enc_buf[512];
+	med::encoder_context<> ectx{ enc_buf };
+	med::asn::ber::reverse_encoder enc{ectx};
+	encode(enc, s);
+
+	auto const out = enc.encoded();
+	ASSERT_EQ(4 + 4 + big.size() + 3, out.size());
+	EXPECT_STREQ("30 82 01 54 80 82 01 4D 00 01 02 ", as_string(out.first(11)));
+	EXPECT_STREQ("4B 4C 82 01 07 ", as_string(out.last(5)));
+
+	EXPECT_TRUE(Matches(big.data(), out.data() + 8, big.size()));
+
+	//not enough space
+	uint8_t small_buf[64];
+	med::encoder_context<> sctx{ small_buf };
+	med::asn::ber::reverse_encoder senc{sctx, med::status_on_error{}};
+	encode(senc, s);
+	EXPECT_EQ(med::error::overflow, senc.status().code());
+}
+
 //8.10 Encoding of a sequence-of value
 #if 1
 TEST(asn_ber, sequence_of)
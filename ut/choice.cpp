@@ -167,6 +167,38 @@ TEST(choice, plain)
 //	EXPECT_FALSE(pf->is_set());
 }
 
+TEST(choice, reset)
+{
+	plain msg;
+	msg.ref<U32>().set(0x12345678);
+	ASSERT_TRUE(msg.is_set());
+
+	msg.reset();
+	EXPECT_FALSE(msg.is_set());
+	EXPECT_EQ(nullptr, msg.get<U32>());
+	//re-selected stale case is cleared
+	EXPECT_FALSE(msg.ref<U32>().is_set());
+
+	//stale case survives repeated reset
+	msg.ref<UNKNOWN>().ref<ANY_TAG>().set(3);
+	msg.reset();
+	msg.reset();
+	ASSERT_FALSE(msg.is_set());
+	EXPECT_FALSE(msg.ref<UNKNOWN>().is_set());
+
+	//other case is created
+	msg.ref<U32>().set(0x12345678);
+	msg.reset();
+	EXPECT_FALSE(msg.ref<U16>().is_set());
+
+	//moved out case isn't reused
+	msg.ref<U32>().set(0x12345678);
+	plain other{std::move(msg)};
+	EXPECT_EQ(0x12345678, other.get<U32>()->get());
+	EXPECT_FALSE(msg.is_set());
+	EXPECT_FALSE(msg.ref<U32>().is_set());
+}
+
 TEST(choice, any)
 {
 	uint8_t encoded[] = {6, 3, 4, 5,6,7,8};
@@ -215,3 +247,56 @@ TEST(choice, nibble_tag)
 }
 #endif
 //NOTE: choice compound is tested in length.cpp ppp::proto
+
+namespace prj {
+
+struct A : med::value<uint8_t> {};
+struct B : med::value<uint16_t> {};
+struct C : med::value<uint8_t> {};
+struct D : med::value<uint8_t> {};
+struct AB : med::sequence<
+	M< A >,
+	M< B >
+>{};
+
+struct CHO : med::choice<
+	M< T<1>, L, A >,
+	M< T<2>, L, B >,
+	M< T<4>, B >,
+	M< T<5>, AB >,
+	M< T<6>, C >
+>{};
+
+struct MSG : med::sequence<
+	M< CHO >,
+	M< T<3>, D >
+>{};
+
+} //end: namespace prj
+
+//case not in projection is skipped w/o the following fields
+TEST(choice, decode_only)
+{
+	auto decode_only = [](auto const& input)
+	{
+		prj::MSG msg;
+		med::decoder_context<> ctx{ input };
+		med::decode<med::only<prj::C, prj::D>>(med::octet_decoder{ctx}, msg);
+		EXPECT_EQ(sizeof(input), ctx.buffer().get_offset());
+		EXPECT_EQ(7, msg.get<prj::D>().get());
+		return msg.get<prj::CHO>().index();
+	};
+
+	//by its length
+	uint8_t const tlv[] = {2, 2, 0x12, 0x34, 3, 7};
+	EXPECT_EQ(prj::CHO::num_types, decode_only(tlv));
+	//of fixed size
+	uint8_t const tv[] = {4, 0x12, 0x34, 3, 7};
+	EXPECT_EQ(prj::CHO::num_types, decode_only(tv));
+	//decoded as can't be skipped
+	uint8_t const eager[] = {5, 1, 0x12, 0x34, 3, 7};
+	EXPECT_EQ(3, decode_only(eager));
+	//in projection
+	uint8_t const proj[] = {6, 9, 3, 7};
+	EXPECT_EQ(4, decode_only(proj));
+}
@@ -1,4 +1,8 @@
 #include "ut.hpp"
+#include "clone.hpp"
+#include <cstring>
+#include <new>
+
 
 namespace cp {
 
@@ -52,6 +56,11 @@ struct seq_r : med::sequence<
 	M< med::counter_t<byte>, word, med::min<2>, med::inf >
 >{};
 
+struct reloc : med::sequence<
+	M< T<0xF1>, byte, med::min<2>, med::inf >,
+	O< T<2>, L, var_extern >
+>{};
+
 } //end: namespace cp
 
 TEST(copy, seq_same)
@@ -177,3 +186,168 @@ TEST(copy, choice_hdr)
 	ASSERT_NE(nullptr, pv);
 	//EXPECT_EQ(0xABBA, pw->get());
 }
+
+//whole arena holding message, its input and allocations relocated as raw memory
+TEST(copy, relocate)
+{
+	uint8_t const encoded[] = {
+		0xF1, 0x13,
+		0xF1, 0x37,
+		0xF1, 0x55, //in external storage
+		2, 3, 1, 2, 3, //extern octets
+	};
+
+	//message isn't trivially copyable (offset_ptr re-targets on copy) thus
+	//only the arena as a whole is copied as raw memory
+	static_assert(not std::is_trivially_copyable_v<cp::reloc>);
+	struct arena
+	{
+		alignas(cp::reloc) uint8_t bytes[512];
+	};
+	static_assert(std::is_trivially_copyable_v<arena>);
+	arena src, dst;
+
+	std::memcpy(src.bytes, encoded, sizeof(encoded));
+	std::size_t msg_ofs = 0;
+	{
+		med::allocator alloc{src.bytes + 16, sizeof(src.bytes) - 16};
+		auto* msg = med::try_create<cp::reloc>(alloc);
+		ASSERT_NE(nullptr, msg);
+		msg_ofs = reinterpret_cast<uint8_t*>(msg) - src.bytes;
+		med::decoder_context<med::allocator> ctx{ src.bytes, sizeof(encoded), &alloc };
+		decode(med::octet_decoder{ctx}, *msg);
+		EXPECT_EQ(3, msg->get<cp::byte>().count());
+	}
+
+	std::memcpy(&dst, &src, sizeof(arena));
+	std::memset(&src, 0, sizeof(arena));
+
+	//same offset in the copy
+	auto const& msg = *std::launder(reinterpret_cast<cp::reloc const*>(dst.bytes + msg_ofs));
+	auto const& bytes = msg.get<cp::byte>();
+	ASSERT_EQ(3, bytes.count());
+	EXPECT_EQ(0x13, bytes[0].get());
+	EXPECT_EQ(0x37, bytes[1].get());
+	EXPECT_EQ(0x55, bytes[2].get());
+	auto const* octs = msg.get<cp::var_extern>();
+	ASSERT_NE(nullptr, octs);
+	ASSERT_EQ(3, octs->size());
+	EXPECT_EQ(dst.bytes + 8, octs->data());
+
+	uint8_t buffer[32];
+	med::encoder_context<> ctx{ buffer };
+	encode(med::octet_encoder{ctx}, msg);
+	EXPECT_EQ(sizeof(encoded), ctx.buffer().get_offset());
+	EXPECT_TRUE(Matches(encoded, buffer));
+}
+
+TEST(copy, move)
+{
+	uint8_t const encoded[] = {
+		0xF1, 0x13,
+		0xF1, 0x37,
+		0xF1, 0x55, //in external storage
+		2, 3, 1, 2, 3,
+	};
+
+	uint8_t dec_buf[128];
+	med::allocator alloc{dec_buf};
+	med::decoder_context<med::allocator> ctx{ encoded, &alloc };
+	cp::reloc src;
+	decode(med::octet_decoder{ctx}, src);
+	auto const* ext = &src.get<cp::byte>()[2];
+
+	cp::reloc dst{std::move(src)};
+	EXPECT_EQ(0, src.get<cp::byte>().count());
+	ASSERT_EQ(3, dst.get<cp::byte>().count());
+	//external storage is stolen
+	EXPECT_EQ(ext, &dst.get<cp::byte>()[2]);
+	EXPECT_EQ(0x13, dst.get<cp::byte>()[0].get());
+	EXPECT_EQ(0x55, dst.get<cp::byte>()[2].get());
+
+	src = std::move(dst);
+	EXPECT_EQ(0, dst.get<cp::byte>().count());
+	ASSERT_EQ(3, src.get<cp::byte>().count());
+	EXPECT_EQ(ext, &src.get<cp::byte>()[2]);
+
+	cp::cho c1;
+	c1.ref<cp::word>().set(0xABBA);
+	cp::cho c2{std::move(c1)};
+	EXPECT_FALSE(c1.is_set());
+	ASSERT_NE(nullptr, c2.get<cp::word>());
+	EXPECT_EQ(0xABBA, c2.get<cp::word>()->get());
+
+	cp::cho c3{c2};
+	ASSERT_NE(nullptr, c3.get<cp::word>());
+	EXPECT_EQ(0xABBA, c3.get<cp::word>()->get());
+	c1 = std::move(c3);
+	EXPECT_FALSE(c3.is_set());
+	ASSERT_NE(nullptr, c1.get<cp::word>());
+	EXPECT_EQ(0xABBA, c1.get<cp::word>()->get());
+}
+
+TEST(copy, clone_into)
+{
+	uint8_t input[] = {
+		0xF1, 0x13,
+		0xF1, 0x37,
+		0xF1, 0x55,
+		0xF1, 0x77,
+		2, 3, 1, 2, 3,
+	};
+
+	uint8_t dec_buf[128];
+	med::allocator dec_alloc{dec_buf};
+	med::decoder_context<med::allocator> ctx{ input, &dec_alloc };
+	cp::reloc src;
+	decode(med::octet_decoder{ctx}, src);
+
+	alignas(cp::reloc) uint8_t arena_buf[256];
+	med::allocator alloc{arena_buf};
+	auto* clone = med::clone_into(src, alloc);
+	ASSERT_NE(nullptr, clone);
+	//laid out contiguously in the target allocator
+	auto const* beg = reinterpret_cast<uint8_t const*>(clone);
+	auto in_arena = [&](void const* p) { return p >= arena_buf && p < arena_buf + sizeof(arena_buf); };
+	EXPECT_EQ(arena_buf, beg);
+	EXPECT_TRUE(in_arena(&clone->get<cp::byte>()[3]));
+	auto const* octs = clone->get<cp::var_extern>();
+	ASSERT_NE(nullptr, octs);
+	EXPECT_TRUE(in_arena(octs->data()));
+
+	//independent from the source and its input
+	std::memset(input, 0, sizeof(input));
+	src.clear();
+	dec_alloc.release();
+	std::memset(dec_buf, 0, sizeof(dec_buf));
+
+	uint8_t const encoded[] = {
+		0xF1, 0x13,
+		0xF1, 0x37,
+		0xF1, 0x55,
+		0xF1, 0x77,
+		2, 3, 1, 2, 3,
+	};
+	uint8_t buffer[32];
+	med::encoder_context<> ectx{ buffer };
+	encode(med::octet_encoder{ectx}, *clone);
+	EXPECT_EQ(sizeof(encoded), ectx.buffer().get_offset());
+	EXPECT_TRUE(Matches(encoded, buffer));
+
+	//not enough space
+	uint8_t small_buf[sizeof(cp::reloc) + 4];
+	med::allocator small{small_buf};
+	EXPECT_THROW(med::clone_into(*clone, small), med::exception);
+
+	//same w/o exceptions including no space for the octets only
+	med::status_on_error err;
+	EXPECT_EQ(nullptr, med::clone_into(*clone, small, err));
+	EXPECT_EQ(med::error::out_of_memory, err.status().code());
+	auto const octs_end = std::size_t(octs->data() - arena_buf) + octs->size();
+	alignas(cp::reloc) uint8_t no_octs_buf[sizeof(arena_buf)];
+	med::allocator no_octs{no_octs_buf, octs_end - 1};
+	err.reset_status();
+	EXPECT_EQ(nullptr, med::clone_into(*clone, no_octs, err));
+	EXPECT_EQ(med::error::out_of_memory, err.status().code());
+	EXPECT_STREQ("octets", err.status().name());
+}
@@ -1,4 +1,10 @@
 #include "ut.hpp"
+#include "stream_decoder.hpp"
+#include "iovec_buffer.hpp"
+#include "segmented_buffer.hpp"
+#include "batch.hpp"
+#include "lazy_set.hpp"
+#include "peek.hpp"
 
 namespace diameter {
 
@@ -368,6 +374,88 @@ TEST(diameter, encode)
 	EXPECT_STREQ(as_string(diameter::dpr), as_string(ctx.buffer()));
 }
 
+TEST(diameter, encode_iovec)
+{
+	diameter::base base;
+	auto& msg = base.ref<diameter::DPR>();
+
+	base.header().ap_id(0);
+	base.header().hop_id(0x22222222);
+	base.header().end_id(0x55555555);
+
+	msg.ref<diameter::origin_host>().set("Orig.Host");
+	msg.ref<diameter::origin_realm>().set("orig.realm.net");
+	msg.ref<diameter::disconnect_cause>().set(2);
+
+	uint8_t buffer[1024] = {};
+	med::encoder_context<med::null_allocator const, med::iovec_buffer<>> ctx{ buffer };
+	ctx.buffer().threshold(8);
+	encode(med::octet_encoder{ctx}, base);
+
+	EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().total_size());
+	//HDR+AVP, Orig.Host, PAD+AVP, orig.realm.net, PAD+AVP
+	auto const chain = ctx.buffer().chain();
+	ASSERT_EQ(5, chain.size());
+	EXPECT_EQ(msg.get<diameter::origin_host>().body().data(), chain[1].iov_base);
+	EXPECT_EQ(msg.get<diameter::origin_realm>().body().data(), chain[3].iov_base);
+
+	uint8_t out[sizeof(diameter::dpr)];
+	std::size_t len = 0;
+	for (auto const& seg : chain)
+	{
+		ASSERT_LE(len + seg.iov_len, sizeof(out));
+		std::memcpy(out + len, seg.iov_base, seg.iov_len);
+		len += seg.iov_len;
+	}
+	ASSERT_EQ(sizeof(diameter::dpr), len);
+	EXPECT_TRUE(Matches(diameter::dpr, out));
+
+	//short strings are copied
+	ctx.reset();
+	ctx.buffer().threshold(med::iovec_buffer<>::DEFAULT_THRESHOLD);
+	encode(med::octet_encoder{ctx}, base);
+	ASSERT_EQ(1, ctx.buffer().chain().size());
+	EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().total_size());
+	EXPECT_STREQ(as_string(diameter::dpr), as_string(ctx.buffer()));
+}
+
+TEST(diameter, encode_iovec_rollback)
+{
+	diameter::base base;
+	auto& msg = base.ref<diameter::DPR>();
+	base.header().ap_id(0);
+	base.header().hop_id(0x22222222);
+	base.header().end_id(0x55555555);
+	msg.ref<diameter::origin_host>().set("Orig.Host");
+	msg.ref<diameter::origin_realm>().set("orig.realm.net");
+	msg.ref<diameter::disconnect_cause>().set(2);
+
+	uint8_t buffer[1024] = {};
+	med::encoder_context<med::null_allocator const, med::iovec_buffer<>> ctx{ buffer };
+	ctx.buffer().threshold(8);
+	encode(med::octet_encoder{ctx}, base);
+	auto const first = ctx.buffer().get_state();
+	auto const num_segs = ctx.buffer().chain().size();
+	ASSERT_EQ(5, num_segs);
+
+	//2nd message referencing the strings too
+	encode(med::octet_encoder{ctx}, base);
+	auto const second = ctx.buffer().get_state();
+	EXPECT_EQ(2*sizeof(diameter::dpr), ctx.buffer().total_size());
+	EXPECT_EQ(std::ptrdiff_t(sizeof(diameter::dpr)), second - first);
+	EXPECT_LT(num_segs, ctx.buffer().chain().size());
+
+	//rolled back to the 1st message
+	ctx.buffer().set_state(first);
+	EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().total_size());
+	EXPECT_EQ(num_segs, ctx.buffer().chain().size());
+	EXPECT_EQ(0, ctx.buffer().get_state() - first);
+
+	//and forward again
+	ctx.buffer().set_state(second);
+	EXPECT_EQ(2*sizeof(diameter::dpr), ctx.buffer().total_size());
+}
+
 TEST(diameter, decode)
 {
 	med::decoder_context<> ctx{ diameter::dpr };
@@ -386,6 +474,96 @@ TEST(diameter, decode)
 	ASSERT_EQ(2, msg->get<diameter::disconnect_cause>().body().get());
 }
 
+TEST(diameter, decode_segmented)
+{
+	using ctx_t = med::decoder_context<med::null_allocator const, med::segmented_buffer<>>;
+	uint8_t const* const host = diameter::dpr + 28;
+
+	for (std::size_t chunk = 1; chunk <= sizeof(diameter::dpr); ++chunk)
+	{
+		::iovec iov[sizeof(diameter::dpr)];
+		std::size_t num = 0;
+		for (std::size_t ofs = 0; ofs < sizeof(diameter::dpr); ofs += chunk)
+		{
+			auto const len = std::min(chunk, sizeof(diameter::dpr) - ofs);
+			iov[num++] = ::iovec{const_cast<uint8_t*>(diameter::dpr + ofs), len};
+		}
+
+		ctx_t ctx;
+		ctx.reset(std::span<::iovec const>{iov, num});
+		diameter::base base;
+		decode(med::octet_decoder{ctx}, base);
+
+		ASSERT_EQ(0x22222222, base.header().hop_id()) << "chunk=" << chunk;
+		ASSERT_EQ(0x55555555, base.header().end_id()) << "chunk=" << chunk;
+		auto const* msg = base.get<diameter::DPR>();
+		ASSERT_NE(nullptr, msg) << "chunk=" << chunk;
+		EQ_STRING_M(diameter::origin_host, "Orig.Host");
+		EQ_STRING_M(diameter::origin_realm, "orig.realm.net");
+		ASSERT_EQ(2, msg->get<diameter::disconnect_cause>().body().get()) << "chunk=" << chunk;
+		EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().get_offset());
+
+		//zero-copy when the string is inside single segment
+		bool const inside = (28 / chunk) == ((28 + 8) / chunk);
+		EXPECT_EQ(inside, host == msg->get<diameter::origin_host>().body().data()) << "chunk=" << chunk;
+	}
+
+	//no space to stitch
+	::iovec iov[sizeof(diameter::dpr)];
+	for (std::size_t i = 0; i < sizeof(diameter::dpr); ++i)
+	{
+		iov[i] = ::iovec{const_cast<uint8_t*>(diameter::dpr + i), 1};
+	}
+	med::decoder_context<med::null_allocator const, med::segmented_buffer<16>> ctx;
+	ctx.reset(std::span<::iovec const>{iov});
+	diameter::base base;
+	EXPECT_THROW(decode(med::octet_decoder{ctx}, base), med::out_of_memory);
+}
+
+TEST(diameter, decode_batch)
+{
+	constexpr std::size_t LEN = sizeof(diameter::dpr);
+	uint8_t input[3 * LEN + 10];
+	for (std::size_t i = 0; i < 3; ++i) { std::memcpy(input + i * LEN, diameter::dpr, LEN); }
+	std::memcpy(input + 3 * LEN, diameter::dpr, 10); //incomplete frame
+	input[LEN + 23] = 0x09; //Origin-Host is unknown AVP in the 2nd message
+
+	using framing = med::length_framing<1, diameter::msg_len>;
+	EXPECT_EQ(LEN, framing::frame_size(input, sizeof(input)));
+	EXPECT_EQ(0, framing::frame_size(input, 3));
+
+	med::decoder_context<> ctx;
+	diameter::base base;
+	std::size_t num = 0;
+	auto const consumed = med::decode_batch<framing>(med::octet_decoder{ctx, med::status_on_error{}}
+		, input, base, [&num](diameter::base const& msg, med::status const& st)
+	{
+		if (num++ == 1)
+		{
+			EXPECT_EQ(med::error::missing_ie, st.code());
+		}
+		else
+		{
+			ASSERT_TRUE(st);
+			auto const* dpr = msg.get<diameter::DPR>();
+			ASSERT_NE(nullptr, dpr);
+			EXPECT_EQ(2, dpr->get<diameter::disconnect_cause>().body().get());
+		}
+	});
+	EXPECT_EQ(3, num);
+	EXPECT_EQ(3 * LEN, consumed);
+
+	//into array
+	diameter::base msgs[2];
+	med::status res[2];
+	auto const count = med::decode_batch<framing>(med::octet_decoder{ctx, med::status_on_error{}}
+		, input, std::span<diameter::base>{msgs}, std::span<med::status>{res});
+	ASSERT_EQ(2, count);
+	EXPECT_TRUE(res[0]);
+	EXPECT_EQ(med::error::missing_ie, res[1].code());
+	EXPECT_EQ(0x22222222, msgs[0].header().hop_id());
+}
+
 TEST(diameter, bad_padding)
 {
 	uint8_t const dpr[] = {
@@ -418,6 +596,65 @@ TEST(diameter, bad_padding)
 	EXPECT_THROW(decode(med::octet_decoder{ctx}, base), med::exception);
 }
 
+TEST(diameter, stream_decode)
+{
+	//fragments are received one after another into the same buffer
+	uint8_t rx[128];
+	med::decoder_context<> ctx;
+	med::stream_decoder sd{ctx};
+	diameter::base base;
+
+	auto receive = [&](std::size_t size)
+	{
+		std::memcpy(rx + sd.size(), diameter::dpr + sd.size(), size);
+		sd.append(size);
+	};
+
+	sd.reset(rx);
+	receive(1); //VER
+	ASSERT_EQ(med::progress::need_more, sd.decode(base));
+	EXPECT_EQ(3, sd.needed()); //LEN
+	receive(2);
+	ASSERT_EQ(med::progress::need_more, sd.decode(base)); //no attempt w/o enough data
+	EXPECT_EQ(1, sd.needed());
+	EXPECT_EQ(1, sd.attempts());
+	receive(1);
+	ASSERT_EQ(med::progress::need_more, sd.decode(base));
+	EXPECT_EQ(sizeof(diameter::dpr) - 4, sd.needed()); //whole message is known
+	EXPECT_EQ(med::error::overflow, sd.status().code());
+	receive(30);
+	ASSERT_EQ(med::progress::need_more, sd.decode(base));
+	EXPECT_EQ(2, sd.attempts());
+	receive(sizeof(diameter::dpr) - 34);
+	ASSERT_EQ(med::progress::done, sd.decode(base));
+	EXPECT_EQ(3, sd.attempts());
+	EXPECT_TRUE(sd.status());
+	EXPECT_EQ(sizeof(diameter::dpr), sd.consumed());
+
+	ASSERT_EQ(0x22222222, base.header().hop_id());
+	auto const* msg = base.get<diameter::DPR>();
+	ASSERT_NE(nullptr, msg);
+	EQ_STRING_M(diameter::origin_host, "Orig.Host");
+	EQ_STRING_M(diameter::origin_realm, "orig.realm.net");
+	ASSERT_EQ(2, msg->get<diameter::disconnect_cause>().body().get());
+
+	//malformed data inside the message is not reported as truncation
+	uint8_t const bad[] = {
+		0x01, 0x00, 0x00, 32,   //VER(1), LEN(3)
+		0x80, 0x00, 0x01, 0x1A, //R.P.E.T(1), CMD(3) = 282
+		0x00, 0x00, 0x00, 0x00, //APP-ID
+		0x22, 0x22, 0x22, 0x22, //H2H-ID
+		0x55, 0x55, 0x55, 0x55, //E2E-ID
+		0x00, 0x00, 0x01, 0x11, //AVP = 273 Disconnect-Cause AVP
+		0x40, 0x00, 0x00, 0x10, //V.M.P(1), LEN(3) = 16 (beyond message)
+		0x00, 0x00, 0x00, 0x02, //cause = 2
+	};
+	sd.reset(bad, sizeof(bad));
+	ASSERT_EQ(med::progress::failed, sd.decode(base));
+	EXPECT_EQ(0, sd.needed());
+	EXPECT_FALSE(sd.status());
+}
+
 TEST(diameter, any_avp)
 {
 	uint8_t const dpa[] = {
@@ -590,3 +827,165 @@ TEST(diameter, any_msg)
 	EXPECT_EQ(sizeof(dwa), ectx.buffer().get_offset());
 	ASSERT_TRUE(Matches(dwa, buffer));
 }
+
+TEST(diameter, lazy_set)
+{
+	uint8_t const avps[] = {
+		0x00, 0x00, 0x01, 0x08, //AVP-CODE = 264 OrigHost
+		0x40, 0x00, 0x00, 0x11, //V.M.P(1), LEN(3) = 17 + padding
+		'O', 'r', 'i', 'g',
+		'.', 'H', 'o', 's',
+		't',   0,   0,   0,
+
+		0x00, 0x00, 0x01, 0x02, //AVP-CODE = 258 Auth-App-Id AVP
+		0x40, 0x00, 0x00, 12,   //V.M.P(1), LEN(3) = 12
+		0xA5, 0x5A, 0xBC, 0xCB, //id
+
+		0x00, 0x00, 0x01, 0x28, //AVP-CODE = 296 OrigRealm
+		0x40, 0x00, 0x00, 22,   //V.M.P(1), LEN(3) = 22
+		'o', 'r', 'i', 'g',
+		'.', 'r', 'e', 'a',
+		'l', 'm', '.', 'n',
+		'e', 't',   0,   0,
+
+		0x00, 0x00, 0x01, 0x0C, //AVP = 268 Result Code
+		0x40, 0x00, 0x00, 12,   //V.M.P(1), LEN(3) = 12
+		0x00, 0x00, 0x0B, 0xBC, //result = 3004
+	};
+
+	med::decoder_context<> ctx{ avps };
+	med::octet_decoder decoder{ctx};
+	med::lazy_set<diameter::DPA> msg;
+	decode(decoder, msg);
+
+	//only headers are scanned
+	auto const index = msg.index();
+	ASSERT_EQ(4, index.size());
+	EXPECT_EQ(264, index[0].tag);
+	EXPECT_EQ(0, index[0].offset);
+	EXPECT_EQ(20, index[0].size);
+	EXPECT_EQ(258, index[1].tag);
+	EXPECT_EQ(20, index[1].offset);
+	EXPECT_EQ(12, index[1].size);
+	EXPECT_EQ(268, index[3].tag);
+	EXPECT_EQ(56, index[3].offset);
+	EXPECT_FALSE(msg.get<diameter::result_code>().is_set());
+	EXPECT_FALSE(msg.get<diameter::origin_host>().is_set());
+
+	msg.check(decoder);
+
+	EXPECT_EQ(3004, msg.get<diameter::result_code>(decoder).body().get());
+	EXPECT_EQ("orig.realm.net"sv, as_sv(msg.get<diameter::origin_realm>(decoder)));
+	EXPECT_FALSE(msg.get<diameter::origin_host>().is_set());
+	EXPECT_EQ(nullptr, msg.get<diameter::error_message>(decoder));
+	ASSERT_EQ(1, msg.get<diameter::any_avp>(decoder).count());
+	EXPECT_EQ(0x102, msg.get<diameter::any_avp>().first()->get<diameter::avp_code>().get());
+
+	//missing mandatory
+	ctx.reset(avps, 56);
+	decode(decoder, msg);
+	EXPECT_EQ(3, msg.index().size());
+	EXPECT_THROW(msg.check(decoder), med::missing_ie);
+}
+
+TEST(diameter, peek)
+{
+	med::decoder_context<> ctx;
+	med::octet_decoder decoder{ctx};
+
+	//header of choice
+	auto const hop = med::peek<diameter::base, diameter::header, diameter::hop_by_hop_id>(decoder, diameter::dpr);
+	ASSERT_TRUE(hop.has_value());
+	EXPECT_EQ(0x22222222, hop->get());
+
+	//AVP of selected case
+	auto const cause = med::peek<diameter::base, diameter::DPR, diameter::disconnect_cause>(decoder, diameter::dpr);
+	ASSERT_TRUE(cause.has_value());
+	EXPECT_EQ(2, cause->body().get());
+	auto const realm = med::peek<diameter::base, diameter::DPR, diameter::origin_realm>(decoder, diameter::dpr);
+	ASSERT_TRUE(realm.has_value());
+	EXPECT_EQ("orig.realm.net"sv, as_sv(*realm));
+
+	//case not selected
+	auto const rc = med::peek<diameter::base, diameter::DPA, diameter::result_code>(decoder, diameter::dpr);
+	EXPECT_FALSE(rc.has_value());
+
+	//IE not present
+	uint8_t const dpr[] = {
+		0x01, 0x00, 0x00, 8*4, //VER(1), LEN(3)
+		0x80, 0x00, 0x01, 0x1A, //R.P.E.T(1), CMD(3) = 282
+		0x00, 0x00, 0x00, 0x00, //APP-ID
+		0x22, 0x22, 0x22, 0x22, //H2H-ID
+		0x55, 0x55, 0x55, 0x55, //E2E-ID
+		0x00, 0x00, 0x01, 0x11, //AVP = 273 Disconnect-Cause AVP
+		0x40, 0x00, 0x00, 0x0C, //V.M.P(1), LEN(3) = 12
+		0x00, 0x00, 0x00, 0x02, //cause = 2
+	};
+	EXPECT_FALSE((med::peek<diameter::base, diameter::DPR, diameter::origin_host>(decoder, dpr).has_value()));
+}
+
+TEST(diameter, decode_only)
+{
+	{
+		med::decoder_context<> ctx{ diameter::dpr };
+		diameter::base base;
+		med::decode<med::only<diameter::origin_realm>>(med::octet_decoder{ctx}, base);
+		EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().get_offset());
+
+		auto const* msg = base.get<diameter::DPR>();
+		ASSERT_NE(nullptr, msg);
+		EQ_STRING_M(diameter::origin_realm, "orig.realm.net");
+		//skipped w/o decoding
+		EXPECT_FALSE(msg->get<diameter::origin_host>().is_set());
+		EXPECT_FALSE(msg->get<diameter::disconnect_cause>().is_set());
+	}
+
+	//case not in projection w/o own length is decoded with its AVPs skipped
+	{
+		med::decoder_context<> ctx{ diameter::dpr };
+		diameter::base base;
+		med::decode<med::only<diameter::result_code>>(med::octet_decoder{ctx}, base);
+		EXPECT_EQ(sizeof(diameter::dpr), ctx.buffer().get_offset());
+		EXPECT_EQ(0x22222222, base.header().hop_id());
+		auto const* msg = base.get<diameter::DPR>();
+		ASSERT_NE(nullptr, msg);
+		EXPECT_FALSE(msg->get<diameter::origin_host>().is_set());
+		EXPECT_EQ(nullptr, base.get<diameter::DPA>());
+	}
+
+	//mandatory IE is checked only if in projection
+	uint8_t const dpr[] = {
+		0x01, 0x00, 0x00, 8*4, //VER(1), LEN(3)
+		0x80, 0x00, 0x01, 0x1A, //R.P.E.T(1), CMD(3) = 282
+		0x00, 0x00, 0x00, 0x00, //APP-ID
+		0x22, 0x22, 0x22, 0x22, //H2H-ID
+		0x55, 0x55, 0x55, 0x55, //E2E-ID
+		0x00, 0x00, 0x01, 0x11, //AVP = 273 Disconnect-Cause AVP
+		0x40, 0x00, 0x00, 0x0C, //V.M.P(1), LEN(3) = 12
+		0x00, 0x00, 0x00, 0x02, //cause = 2
+	};
+	{
+		med::decoder_context<> ctx{ dpr };
+		diameter::base base;
+		med::decode<med::only<diameter::disconnect_cause>>(med::octet_decoder{ctx}, base);
+		auto const* msg = base.get<diameter::DPR>();
+		ASSERT_NE(nullptr, msg);
+		EXPECT_EQ(2, msg->get<diameter::disconnect_cause>().body().get());
+	}
+	{
+		med::decoder_context<> ctx{ dpr };
+		diameter::base base;
+		EXPECT_THROW(med::decode<med::only<diameter::origin_host>>(med::octet_decoder{ctx}, base), med::exception);
+	}
+	//error is reported via caller's decoder policy
+	{
+		med::decoder_context<> ctx{ dpr };
+		med::octet_decoder decoder{ctx, med::status_on_error{}};
+		diameter::base base;
+		auto const st = med::decode<med::only<diameter::origin_host>>(decoder, base);
+		EXPECT_FALSE(st);
+		EXPECT_EQ(med::error::missing_ie, st.code());
+		EXPECT_TRUE(decoder.failed());
+		EXPECT_EQ(med::error::missing_ie, decoder.status().code());
+	}
+}
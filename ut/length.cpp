@@ -279,6 +279,23 @@ struct SLEN : med::sequence<
 {
 };
 
+//nested length-prefixed IEs
+struct LEAF : med::sequence<
+	M< T<1>, L, U16 >,
+	O< T<2>, L, U32 >
+>{};
+struct GRP1 : med::sequence<
+	M< T<3>, L, LEAF >,
+	M< U8 >
+>{};
+struct GRP2 : med::sequence<
+	M< T<4>, L, GRP1 >
+>{};
+struct NESTED : med::sequence<
+	M< L, GRP2 >,
+	M< U8 >
+>{};
+
 } //namespace len
 
 TEST(length, m_lmv)
@@ -586,3 +603,59 @@ TEST(length, setter_with_length)
 	ASSERT_STREQ(as_string(encoded), as_string(ctx.buffer()));
 	check_decode(msg, ctx.buffer());
 }
+
+TEST(length, nested)
+{
+	using namespace len;
+	NESTED msg;
+	auto& grp1 = msg.ref<GRP2>().ref<GRP1>();
+	grp1.ref<LEAF>().ref<U16>().set(0x1234);
+	grp1.ref<LEAF>().ref<U32>().set(0x01020304);
+	grp1.ref<U8>().set(0x56);
+	msg.ref<U8>().set(0x78);
+
+	uint8_t buffer[64];
+	med::encoder_context<> ctx{ buffer };
+	med::octet_encoder enc{ctx};
+	encode(enc, msg);
+
+	uint8_t const encoded[] = {
+		27,
+		0,0,0,4, 22,
+			0,0,0,3, 16,
+				0,0,0,1, 2, 0x12, 0x34,
+				0,0,0,2, 4, 0x01, 0x02, 0x03, 0x04,
+			0x56,
+		0x78
+	};
+	ASSERT_STREQ(as_string(encoded), as_string(ctx.buffer()));
+	EXPECT_EQ(sizeof(encoded), med::field_length(msg, enc));
+	check_decode(msg, ctx.buffer());
+}
+
+TEST(length, encoded_size)
+{
+	using namespace len;
+	NESTED msg;
+	auto& grp1 = msg.ref<GRP2>().ref<GRP1>();
+	grp1.ref<LEAF>().ref<U16>().set(0x1234);
+	grp1.ref<LEAF>().ref<U32>().set(0x01020304);
+	grp1.ref<U8>().set(0x56);
+	msg.ref<U8>().set(0x78);
+
+	//size, reserve, write
+	med::encoder_context<med::null_allocator const, med::unchecked_buffer<>> ctx{nullptr, 0};
+	med::octet_encoder enc{ctx};
+	auto const size = med::encoded_size(enc, msg);
+	std::vector<uint8_t> out(size);
+	ctx.reset(out.data(), out.size());
+	encode(enc, msg);
+	EXPECT_EQ(29, size);
+	EXPECT_EQ(size, ctx.buffer().get_offset());
+
+	uint8_t buffer[64];
+	med::encoder_context<> checked{ buffer };
+	encode(med::octet_encoder{checked}, msg);
+	ASSERT_STREQ(as_string(checked.buffer()), as_string(ctx.buffer()));
+	check_decode(msg, ctx.buffer());
+}
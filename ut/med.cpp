@@ -2,6 +2,8 @@
 #include "ut_proto.hpp"
 
 #include "update.hpp"
+#include "skeleton.hpp"
+#include "encoded_size.hpp"
 
 static_assert (med::AAllocator<med::null_allocator>);
 
@@ -332,6 +334,161 @@ TEST(update, unused)
 }
 #endif
 
+namespace skel {
+
+struct U8 : med::value<uint8_t> {};
+struct U16 : med::value<uint16_t> {};
+struct SEQNUM : med::value<uint32_t>, med::with_snapshot
+{
+	static constexpr auto name() { return "Sequence-Number"; }
+};
+struct HOST : med::octet_string<med::min<1>, med::max<32>>, med::with_snapshot
+{
+	static constexpr auto name() { return "Host"; }
+};
+struct AVP : med::sequence<
+	M< T<1>, L, U16 >,
+	M< T<2>, L, HOST >
+>{};
+struct MSG : med::sequence<
+	M< U8 >,
+	M< T<3>, L, AVP >,
+	M< SEQNUM >
+>{};
+
+} //end: namespace skel
+
+TEST(skeleton, emit)
+{
+	skel::MSG msg;
+	msg.ref<skel::U8>().set(1);
+	msg.ref<skel::AVP>().ref<skel::U16>().set(0x1234);
+	msg.ref<skel::AVP>().ref<skel::HOST>().set("abc"sv);
+	msg.ref<skel::SEQNUM>().set(7);
+
+	med::skeleton<skel::MSG, 64, skel::SEQNUM, skel::HOST> sk;
+	sk.prepare(msg);
+	uint8_t const prepared[] = {1, 3, 9, 1, 2, 0x12, 0x34, 2, 3, 'a', 'b', 'c', 0, 0, 0, 7};
+	ASSERT_STREQ(as_string(prepared), as_string(sk.bytes()));
+
+	auto check_emit = [&](uint32_t seqnum, std::string_view host)
+	{
+		skel::SEQNUM sn;
+		sn.set(seqnum);
+		skel::HOST h;
+		h.set(host);
+
+		uint8_t buffer[64];
+		med::encoder_context<> ctx{ buffer };
+		sk.emit(med::octet_encoder{ctx}, sn, h);
+
+		msg.ref<skel::SEQNUM>().set(seqnum);
+		msg.ref<skel::AVP>().ref<skel::HOST>().set(host);
+		uint8_t expected[64];
+		med::encoder_context<> exp_ctx{ expected };
+		encode(med::octet_encoder{exp_ctx}, msg);
+		std::string const exp_str = as_string(exp_ctx.buffer()); //NOTE: as_string is not reentrant
+		EXPECT_EQ(exp_str, as_string(ctx.buffer()));
+	};
+
+	check_emit(8, "xyz");      //same size
+	check_emit(9, "hostname"); //grown
+	check_emit(10, "h");       //shrunk
+
+	//output too short
+	uint8_t buffer[8];
+	med::encoder_context<> ctx{ buffer };
+	skel::SEQNUM sn;
+	sn.set(1);
+	skel::HOST h;
+	h.set("abc"sv);
+	EXPECT_THROW(sk.emit(med::octet_encoder{ctx}, sn, h), med::overflow);
+
+	//not present
+	msg.ref<skel::AVP>().ref<skel::HOST>().clear();
+	med::skeleton<skel::AVP, 16, skel::HOST> missing;
+	EXPECT_THROW(missing.prepare(msg.get<skel::AVP>()), med::missing_ie);
+	EXPECT_EQ(0, missing.size());
+	EXPECT_EQ(med::error::missing_ie, missing.prepare(msg.get<skel::AVP>(), med::status_on_error{}).code());
+	EXPECT_EQ(0, missing.size());
+}
+
+namespace esz {
+
+struct U8 : med::value<uint8_t> {};
+struct U16 : med::value<uint16_t> {};
+struct B4 : med::value<med::bits<4>> {};
+struct B12 : med::value<med::bits<12, 4>> {};
+struct STR : med::octet_string<med::min<2>, med::max<10>> {};
+struct ANY : med::octet_string<> {};
+
+struct SEQ : med::sequence<
+	M< B4 >,                        //0.5
+	M< B12 >,                       //1.5
+	O< T<1>, L, STR >,              //0 or 1+1+[2..10]
+	M< CNT, U16, med::max<3> >,     //2+2*[1..3]
+	O< T<2>, U8, med::max<2> >      //[0..2]*2
+>{};
+
+struct OPEN : med::sequence<
+	M< U8 >,
+	O< T<1>, L, ANY >
+>{};
+
+struct HDR : med::sequence<
+	M< U8 >, //tag
+	M< U16 >
+>
+{
+	auto get_tag() const    { return get<U8>().get(); }
+	void set_tag(uint8_t v) { ref<U8>().set(v); }
+};
+
+struct PLAIN : med::choice<
+	M< T<1>, U8 >,
+	M< T<2>, L, SEQ >
+>{};
+
+struct COMPOUND : med::choice< HDR
+	, M< C<1>, U8 >
+	, M< C<2>, SEQ >
+>{};
+
+} //end: namespace esz
+
+TEST(encoded_size, bounds)
+{
+	static_assert(1 == med::min_encoded_size_v<esz::U8>);
+	static_assert(1 == med::max_encoded_size_v<esz::U8>);
+	static_assert(2 == med::min_encoded_size_v<esz::STR>);
+	static_assert(10 == med::max_encoded_size_v<esz::STR>);
+
+	static_assert(2 + 2 + 2 == med::min_encoded_size_v<esz::SEQ>);
+	static_assert(2 + 12 + 2 + 6 + 4 == med::max_encoded_size_v<esz::SEQ>);
+
+	static_assert(1 == med::min_encoded_size_v<esz::OPEN>);
+	static_assert(med::unbounded_size == med::max_encoded_size_v<esz::OPEN>);
+
+	static_assert(2 == med::min_encoded_size_v<esz::PLAIN>);
+	static_assert(1 + 1 + 26 == med::max_encoded_size_v<esz::PLAIN>);
+	static_assert(3 + 1 == med::min_encoded_size_v<esz::COMPOUND>);
+	static_assert(3 + 26 == med::max_encoded_size_v<esz::COMPOUND>);
+
+	//buffer sized statically fits the largest message
+	esz::SEQ msg;
+	msg.ref<esz::B4>().set(1);
+	msg.ref<esz::B12>().set(2);
+	uint8_t const str[10] = {};
+	msg.ref<esz::STR>().set(str);
+	for (uint16_t i = 0; i < 3; ++i) { msg.ref<esz::U16>().push_back()->set(i); }
+	for (uint8_t i = 0; i < 2; ++i) { msg.ref<esz::U8>().push_back()->set(i); }
+
+	uint8_t buffer[med::max_encoded_size_v<esz::SEQ>];
+	med::encoder_context<> ctx{ buffer };
+	encode(med::octet_encoder{ctx}, msg);
+	EXPECT_EQ(sizeof(buffer), ctx.buffer().get_offset());
+}
+
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);
@@ -1,4 +1,9 @@
+#include <cstring>
+#include <vector>
+
 #include "ut.hpp"
+#include "batch.hpp"
+#include "stream_decoder.hpp"
 
 namespace multi {
 
@@ -14,11 +19,33 @@ struct U16 : med::value<uint16_t> {};
 struct U24 : med::value<med::bytes<3>> {};
 struct U32 : med::value<uint32_t> {};
 
+struct STREAM : med::sequence<
+	O< T<2>, U16, med::inf >,
+	M< T<3>, L, U32 >
+>{};
+
+struct BODY : med::sequence<
+	O< T<1>, U8 >,
+	O< T<2>, U16, med::inf >
+>{};
+struct FRAMED : med::sequence<
+	M< L, BODY >
+>{};
+
 struct M1 : med::sequence<
 	M< T<1>, U8, med::max<3>>,
 	O< T<2>, U16, med::inf>
 >{};
 
+struct NESTED : med::sequence<
+	M< T<1>, U8 >,
+	O< T<2>, U16, med::inf >
+>{};
+
+struct M2 : med::sequence<
+	M< NESTED, med::max<3> >
+>{};
+
 } //end: namespace multi
 
 TEST(multi, pop_back)
@@ -141,3 +168,197 @@ TEST(multi, erase)
 	EXPECT_EQ(sizeof(encoded), ctx.buffer().get_offset());
 	EXPECT_TRUE(Matches(encoded, buffer));
 }
+
+//fields after erased one are moved along with external storage of nested ones
+TEST(multi, erase_nested)
+{
+	using namespace multi;
+	M2 msg;
+	auto& mie = msg.ref<NESTED>();
+
+	alignas(8) uint8_t storage[512];
+	med::allocator alloc{storage};
+
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		auto* p = mie.push_back();
+		p->ref<U8>().set(i);
+		for (uint16_t j = 0; j < 5; ++j) { p->ref<U16>().push_back(alloc)->set(10 * i + j); }
+	}
+	auto const* ext = &mie[2].ref<U16>()[4];
+
+	mie.erase(mie.begin()); //(1,2)
+	ASSERT_EQ(2, mie.count());
+	for (uint8_t i = 0; i < 2; ++i)
+	{
+		EXPECT_EQ(i + 1, mie[i].get<U8>().get());
+		auto& nested = mie[i].ref<U16>();
+		ASSERT_EQ(5, nested.count());
+		for (uint16_t j = 0; j < 5; ++j) { EXPECT_EQ(10 * (i + 1) + j, nested[j].get()); }
+	}
+	//external storage is moved w/o copy
+	EXPECT_EQ(ext, &mie[1].ref<U16>()[4]);
+
+	//the slot left is cleared
+	auto* p = mie.push_back();
+	EXPECT_FALSE(p->is_set());
+	EXPECT_TRUE(p->ref<U16>().empty());
+}
+
+TEST(multi, contiguous)
+{
+	using namespace multi;
+	M1 msg;
+	auto& mie = msg.ref<U16>();
+
+	alignas(8) uint8_t storage[256];
+	med::allocator alloc{storage};
+
+	//1 inplace + blocks of 4 and 8 allocated at once
+	ASSERT_TRUE(mie.reserve(13, alloc));
+	for (uint16_t i = 0; i < 13; ++i) { mie.push_back(alloc)->set(i); }
+	EXPECT_EQ(13, mie.count());
+	for (uint16_t i = 0; i < 13; ++i) { EXPECT_EQ(i, mie[i].get()); }
+	//external blocks are adjacent
+	for (std::size_t i = 2; i < 13; ++i) { EXPECT_EQ(&mie[i - 1] + 1, &mie[i]); }
+	//no allocation within reserved
+	alloc.reset(storage, 0);
+	mie.pop_back();
+	EXPECT_EQ(12, mie.count());
+	EXPECT_EQ(11, mie.last()->get());
+	ASSERT_NE(nullptr, mie.push_back(alloc));
+	EXPECT_THROW(mie.push_back(alloc), med::out_of_memory);
+
+	mie.clear();
+	EXPECT_TRUE(mie.empty());
+	EXPECT_EQ(mie.begin(), mie.end());
+}
+
+TEST(multi, reuse_inplace)
+{
+	using namespace multi;
+	M1 msg;
+	auto& mie = msg.ref<U8>();
+
+	for (int round = 0; round < 3; ++round)
+	{
+		for (uint8_t i = 0; i < 3; ++i) { mie.push_back()->set(i); }
+		EXPECT_THROW(mie.push_back(), med::out_of_memory);
+
+		//slots are returned by erase and pop_back
+		mie.erase(mie.begin()); //(1,2)
+		mie.pop_back();         //(1)
+		mie.push_back()->set(7);
+		mie.push_back()->set(8);
+		EXPECT_EQ(3, mie.count());
+		EXPECT_EQ(1, mie[0].get());
+		EXPECT_EQ(7, mie[1].get());
+		EXPECT_EQ(8, mie[2].get());
+
+		msg.clear<U8>();
+		EXPECT_TRUE(mie.empty());
+	}
+}
+
+TEST(multi, unbounded)
+{
+	using namespace multi;
+	M1 msg;
+	auto& mie = msg.ref<U16>();
+	//only pointers to first few blocks are kept inplace
+	static_assert(sizeof(mie) <= 8 * sizeof(void*));
+
+	std::vector<uint64_t> storage(1 << 20);
+	med::allocator alloc{storage.data(), storage.size() * sizeof(storage[0])};
+
+	constexpr std::size_t num = 400000;
+	for (std::size_t i = 0; i < num; ++i) { ASSERT_NE(nullptr, mie.push_back(alloc)) << i; mie.last()->set(uint16_t(i)); }
+	EXPECT_EQ(num, mie.count());
+	EXPECT_EQ(uint16_t(num - 1), mie[num - 1].get());
+	EXPECT_EQ(uint16_t(262141), mie[262141].get());
+
+	//beyond max
+	auto& bounded = msg.ref<U8>();
+	for (std::size_t i = 0; i < 3; ++i) { ASSERT_NE(nullptr, bounded.push_back(alloc)); }
+	try
+	{
+		bounded.push_back(alloc);
+		FAIL() << "extra_ie expected";
+	}
+	catch (med::extra_ie const& ex)
+	{
+		EXPECT_NE(nullptr, std::strstr(ex.what(), "got 4"));
+	}
+}
+
+//each retry re-decodes the fields allocated by the previous attempt
+TEST(multi, stream_retry)
+{
+	using namespace multi;
+	uint8_t rx[128];
+	std::size_t size = 0;
+	for (uint16_t i = 0; i < 20; ++i)
+	{
+		rx[size++] = 2;
+		rx[size++] = uint8_t(i >> 8);
+		rx[size++] = uint8_t(i);
+	}
+	std::size_t const head = size;
+	for (uint8_t const b : {3, 4, 1, 2, 3, 4}) { rx[size++] = b; }
+
+	alignas(8) uint8_t storage[192];
+	med::allocator alloc{storage};
+	med::decoder_context<med::allocator> ctx{nullptr, 0, &alloc};
+	med::stream_decoder sd{ctx};
+	STREAM msg;
+
+	sd.reset(rx, head);
+	for (std::size_t i = head; i < size; ++i)
+	{
+		ASSERT_EQ(med::progress::need_more, sd.decode(msg)) << int(sd.status().code());
+		sd.append(1);
+	}
+	ASSERT_EQ(med::progress::done, sd.decode(msg)) << int(sd.status().code());
+	EXPECT_EQ(4, sd.attempts()); //no tag, no length, no value, done
+	EXPECT_EQ(20, msg.get<U16>().count());
+	EXPECT_EQ(19, msg.get<U16>().last()->get());
+	EXPECT_EQ(0x01020304, msg.get<U32>().get());
+}
+
+//each frame is decoded into cleared message with allocator released
+TEST(multi, batch_release)
+{
+	using namespace multi;
+	uint8_t input[3 * 31];
+	std::size_t size = 0;
+	for (std::size_t k = 0; k < 3; ++k)
+	{
+		input[size++] = 30;
+		for (uint16_t i = 0; i < 10; ++i)
+		{
+			input[size++] = 2;
+			input[size++] = uint8_t(k);
+			input[size++] = uint8_t(i);
+		}
+	}
+
+	alignas(8) uint8_t storage[64];
+	med::allocator alloc{storage};
+	med::decoder_context<med::allocator> ctx{nullptr, 0, &alloc};
+	FRAMED msg;
+	msg.ref<BODY>().ref<U8>().set(1); //left from elsewhere
+
+	std::size_t num = 0;
+	auto const consumed = med::decode_batch<med::length_framing<0, U8>>(med::octet_decoder{ctx, med::status_on_error{}}
+		, input, msg, [&num](FRAMED const& m, med::status const& st)
+	{
+		ASSERT_TRUE(st) << num;
+		auto const& body = m.get<BODY>();
+		EXPECT_EQ(nullptr, body.get<U8>());
+		EXPECT_EQ(10, body.get<U16>().count());
+		EXPECT_EQ((num << 8) | 9, body.get<U16>().last()->get());
+		++num;
+	});
+	EXPECT_EQ(3, num);
+	EXPECT_EQ(sizeof(input), consumed);
+}
@@ -34,6 +34,18 @@ uint8_t const plain_encoded[] = {
 	0x20, 0x80, 0x02, //(T{4}<<3)|Varint{0}, value{256}
 };
 
+/*
+message required {
+	required int32 int_32 = 1;
+	required int64 int_64 = 2;
+}
+*/
+//fields can go in any order
+struct required : med::set<
+	M< T<1, wire_type::VARINT>, int32 >,
+	M< T<2, wire_type::VARINT>, int64 >
+>{};
+
 } //end: namespace pb
 
 #define OPT_CHECK(MSG, FIELD, VALUE) \
@@ -73,3 +85,44 @@ TEST(protobuf, decode_plain)
 	OPT_CHECK(cmsg, uint32, 128);
 	OPT_CHECK(cmsg, uint64, 256);
 }
+
+TEST(protobuf, decode_status)
+{
+	auto decode_status = [](auto const& input)
+	{
+		pb::required msg;
+		med::decoder_context<> ctx{ input };
+		return decode(med::protobuf::decoder{ctx, med::status_on_error{}}, msg);
+	};
+
+	uint8_t const ok[] = {0x08, 0x01, 0x10, 0x7F};
+	EXPECT_TRUE(decode_status(ok));
+
+	//no int_64
+	uint8_t const missing[] = {0x08, 0x01};
+	EXPECT_EQ(med::error::missing_ie, decode_status(missing).code());
+
+	//varint is cut
+	uint8_t const truncated[] = {0x08, 0x01, 0x10, 0x81};
+	EXPECT_EQ(med::error::overflow, decode_status(truncated).code());
+
+	//varint is longer than its max length
+	uint8_t const bad_length[] = {0x08, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+	EXPECT_EQ(med::error::invalid_value, decode_status(bad_length).code());
+}
+
+TEST(protobuf, encode_status)
+{
+	pb::required msg;
+	uint8_t buffer[4];
+	med::encoder_context<> ctx{ buffer };
+
+	//no int_64
+	msg.ref<int32>().set(1);
+	EXPECT_EQ(med::error::missing_ie, encode(med::protobuf::encoder{ctx, med::status_on_error{}}, msg).code());
+
+	//no space
+	ctx.reset();
+	msg.ref<int64>().set(0x7FFFFFFF);
+	EXPECT_EQ(med::error::overflow, encode(med::protobuf::encoder{ctx, med::status_on_error{}}, msg).code());
+}
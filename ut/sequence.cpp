@@ -2,6 +2,10 @@
 
 #include "ut.hpp"
 #include "ut_proto.hpp"
+#include "peek.hpp"
+#include "skeleton.hpp"
+#include "tracked.hpp"
+#include "update.hpp"
 
 
 TEST(seq, bits)
@@ -25,6 +29,59 @@ TEST(seq, bits)
 	check_octet_decode(v, {0b1011'0110, 0b1110'1101});
 }
 
+//all fields are mandatory byte-aligned values encoded in words
+TEST(seq, fixed_layout)
+{
+	struct U8 : med::value<uint8_t> {};
+	struct U24 : med::value<med::bytes<3>> {};
+	struct U32 : med::value<uint32_t> {};
+	struct FIX : med::value<med::fixed<0xAB, uint8_t>> {};
+	struct I16 : med::value<int16_t> {};
+	struct U64 : med::value<uint64_t> {};
+	struct FIXED : med::sequence<
+		M< U8 >,
+		M< U24 >,
+		M< U32 >,
+		M< FIX >,
+		M< I16 >,
+		M< U64 >
+	>
+	{};
+	static_assert(med::sl::is_fixed_layout<med::octet_encoder<med::encoder_context<>>, FIXED::ies_types>::value);
+	static_assert(19 == med::sl::fixed_layout<FIXED::ies_types>::size);
+
+	FIXED v;
+	v.ref<U8>().set(0x01);
+	v.ref<U24>().set(0x020304);
+	v.ref<U32>().set(0x05060708);
+	v.ref<I16>().set(-2);
+	v.ref<U64>().set(0x1112131415161718);
+
+	std::initializer_list<uint8_t> const encoded = {
+		0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+		0xAB, 0xFF, 0xFE,
+		0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+	};
+	check_octet_encode(v, encoded);
+	check_octet_decode(v, encoded);
+
+	//falls back to field by field to report the error
+	FIXED unset;
+	uint8_t buffer[32];
+	med::encoder_context ectx{ buffer };
+	EXPECT_THROW(encode(med::octet_encoder{ectx}, unset), med::missing_ie);
+	uint8_t const short_buf[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xAB};
+	med::decoder_context dctx{ short_buf };
+	EXPECT_THROW(decode(med::octet_decoder{dctx}, unset), med::overflow);
+	uint8_t const invalid[] = {
+		0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+		0xAC, 0xFF, 0xFE,
+		0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+	};
+	dctx.reset(invalid);
+	EXPECT_THROW(decode(med::octet_decoder{dctx}, unset), med::invalid_value);
+}
+
 TEST(seq, ooo) //out-of-order
 {
 	OOO_SEQ msg;
@@ -565,6 +622,83 @@ TEST(seq, dec_seq_fail)
 	EXPECT_THROW(decode(med::octet_decoder{ctx}, proto), med::overflow);
 }
 
+TEST(seq, dec_seq_fail_status)
+{
+	PROTO proto;
+	auto const check = [&](auto const& encoded, med::error code)
+	{
+		med::decoder_context<> ctx{ encoded };
+		auto const st = decode(med::octet_decoder{ctx, med::status_on_error{}}, proto);
+		EXPECT_FALSE(st);
+		EXPECT_EQ(code, st.code());
+	};
+
+	//wrong choice tag
+	uint8_t const wrong_choice[] = { 100, 37, 0x49 };
+	check(wrong_choice, med::error::unknown_tag);
+
+	//wrong tag of required field 2
+	uint8_t const wrong_tag[] = { 2, 37, 0x49, 0xDA, 0xBE, 0xEF };
+	check(wrong_tag, med::error::unknown_tag);
+
+	//missing required field
+	uint8_t const missing[] = { 1, 37 };
+	check(missing, med::error::overflow);
+
+	//invalid length of variable field (shorter)
+	uint8_t const bad_var_len_lo[] = { 1
+		, 37
+		, 0x21, 0x35, 0xD9
+		, 3, 0xDA, 0xBE, 0xEF
+		, 0x42, 4, 0xFE, 0xE1, 0xAB, 0xBA
+		, 0x12, 1, 't','e','s','t'
+	};
+	check(bad_var_len_lo, med::error::invalid_value);
+
+	//same text as of exception
+	med::decoder_context<> ctx{ missing };
+	auto const st = decode(med::octet_decoder{ctx, med::status_on_error{}}, proto);
+	char sz[128];
+	ctx.reset(missing, sizeof(missing));
+	try
+	{
+		decode(med::octet_decoder{ctx}, proto);
+		FAIL();
+	}
+	catch (med::overflow const& ex)
+	{
+		EXPECT_EQ(0, std::strncmp(ex.what(), st.format(sz, sizeof(sz)), std::strlen(sz)));
+	}
+
+	//success
+	uint8_t const encoded[] = { 1, 37, 0x21, 0x35, 0xD9, 3, 0xDA, 0xBE, 0xEF, 0x42, 4, 0xFE, 0xE1, 0xAB, 0xBA };
+	ctx.reset(encoded, sizeof(encoded));
+	EXPECT_TRUE(decode(med::octet_decoder{ctx, med::status_on_error{}}, proto));
+}
+
+TEST(seq, enc_seq_fail_status)
+{
+	PROTO proto;
+	uint8_t buffer[1024];
+	med::encoder_context<> ctx{ buffer };
+
+	auto& msg = proto.ref<MSG_SEQ>();
+	msg.ref<FLD_UC>().set(0);
+	msg.ref<FLD_U24>().set(0);
+
+	auto st = encode(med::octet_encoder{ctx, med::status_on_error{}}, proto);
+	EXPECT_EQ(med::error::missing_ie, st.code());
+
+	msg.ref<FLD_U16>().set(0);
+	msg.ref<FLD_IP>().set(0);
+	ctx.reset(buffer, 4);
+	st = encode(med::octet_encoder{ctx, med::status_on_error{}}, proto);
+	EXPECT_EQ(med::error::overflow, st.code());
+
+	ctx.reset(buffer, sizeof(buffer));
+	EXPECT_TRUE(encode(med::octet_encoder{ctx, med::status_on_error{}}, proto));
+}
+
 TEST(seq, dec_mseq_ok)
 {
 	PROTO proto;
@@ -872,3 +1006,252 @@ TEST(seq, dec_alloc_fail)
 
 	ASSERT_THROW(decode(med::octet_decoder{ctx}, msg), med::out_of_memory);
 }
+
+TEST(decode, seq_peek)
+{
+	uint8_t const encoded[] = { 1
+		, 37
+		, 0x21, 0x35, 0xD9
+		, 3, 0xDA, 0xBE, 0xEF
+		, 0x42, 4, 0xFE, 0xE1, 0xAB, 0xBA
+	};
+	med::decoder_context<> ctx;
+	med::octet_decoder decoder{ctx};
+
+	auto const u24 = med::peek<PROTO, MSG_SEQ, FLD_U24>(decoder, encoded);
+	ASSERT_TRUE(u24.has_value());
+	EXPECT_EQ(0xDABEEF, u24->get());
+
+	auto const dw = med::peek<PROTO, MSG_SEQ, FLD_DW>(decoder, encoded);
+	EXPECT_FALSE(dw.has_value());
+
+	auto const uc = med::peek<PROTO, MSG_SET, FLD_UC>(decoder, encoded);
+	EXPECT_FALSE(uc.has_value());
+}
+
+namespace pks {
+
+struct A : med::octet_string<> {};
+struct B : med::value<uint8_t> {};
+struct S : med::set<
+	O< T<1>, med::length_t<med::value<uint32_t>>, A >,
+	O< T<2>, B >
+>{};
+
+} //end: namespace pks
+
+TEST(decode, peek_huge_length)
+{
+	//length doesn't fit in int
+	uint8_t const encoded[] = {1, 0xFF, 0xFF, 0xFF, 0xFB, 0};
+	med::decoder_context<> ctx;
+	med::octet_decoder decoder{ctx};
+
+	EXPECT_THROW((med::peek<pks::S, pks::B>(decoder, encoded)), med::overflow);
+}
+
+namespace trk {
+
+struct U8 : med::value<uint8_t> {};
+struct U16 : med::value<uint16_t> {};
+struct U32 : med::value<uint32_t> {};
+struct HOP : med::value<uint32_t> {};
+struct ROUTE : med::octet_string<med::min<1>, med::max<16>> {};
+
+struct GRP : med::tracked<med::sequence<
+	M< T<1>, L, U16 >,
+	M< T<2>, L, U32 >
+>>{};
+
+struct MSG : med::tracked<med::sequence<
+	M< U8 >,
+	M< T<3>, L, GRP >,
+	M< T<4>, L, HOP >,
+	O< T<5>, L, ROUTE, med::max<4> >
+>>{};
+
+//tracked group within non-tracked one
+struct MID : med::sequence<
+	M< T<6>, L, GRP >,
+	O< T<5>, L, ROUTE, med::max<4> >
+>{};
+struct NMSG : med::tracked<med::sequence<
+	M< U8 >,
+	M< T<7>, L, MID >
+>>{};
+
+struct SEQNUM : med::value<uint32_t>, med::with_snapshot
+{
+	static constexpr auto name() { return "Sequence-Number"; }
+};
+struct SGRP : med::tracked<med::sequence<
+	M< T<1>, L, U16 >,
+	M< T<2>, L, SEQNUM >
+>>{};
+struct SMSG : med::tracked<med::sequence<
+	M< U8 >,
+	M< T<3>, L, SGRP >
+>>{};
+
+} //end: namespace trk
+
+TEST(seq, tracked)
+{
+	uint8_t encoded[] = {
+		0x11,
+		3, 10, 1, 2, 0x12, 0x34, 2, 4, 0x01, 0x02, 0x03, 0x04,
+		4, 4, 0, 0, 0, 7,
+		5, 3, 'a', 'b', 'c',
+	};
+
+	trk::MSG msg;
+	med::decoder_context<> dctx{ encoded };
+	decode(med::octet_decoder{dctx}, msg);
+	EXPECT_FALSE(msg.modified());
+	EXPECT_EQ(sizeof(encoded), msg.origin().size());
+	EXPECT_EQ(encoded + 3, msg.get<trk::GRP>().origin().data());
+
+	uint8_t buffer[64];
+	med::encoder_context<> ctx{ buffer };
+	//unmodified is copied as is
+	encode(med::octet_encoder{ctx}, msg);
+	EXPECT_STREQ(as_string(encoded), as_string(ctx.buffer()));
+
+	auto expect_encoded = [&](trk::MSG const& m)
+	{
+		//full encode of the same content w/o origin
+		trk::MSG full;
+		full.copy(m, dctx);
+		EXPECT_TRUE(full.origin().empty());
+		uint8_t expected[64];
+		med::encoder_context<> exp_ctx{ expected };
+		encode(med::octet_encoder{exp_ctx}, full);
+
+		ctx.reset();
+		encode(med::octet_encoder{ctx}, m);
+		std::string const exp_str = as_string(exp_ctx.buffer()); //NOTE: as_string is not reentrant
+		EXPECT_EQ(exp_str, as_string(ctx.buffer()));
+	};
+
+	//only the top is re-encoded while unmodified group is copied
+	msg.ref<trk::HOP>().set(8);
+	EXPECT_TRUE(msg.modified());
+	EXPECT_FALSE(msg.get<trk::GRP>().modified());
+	encoded[12] = 0x05; //U32 of group is taken from input as is
+	ctx.reset();
+	encode(med::octet_encoder{ctx}, msg);
+	uint8_t const copied[] = {
+		0x11,
+		3, 10, 1, 2, 0x12, 0x34, 2, 4, 0x01, 0x02, 0x03, 0x05,
+		4, 4, 0, 0, 0, 8,
+		5, 3, 'a', 'b', 'c',
+	};
+	EXPECT_STREQ(as_string(copied), as_string(ctx.buffer()));
+	encoded[12] = 0x04;
+	expect_encoded(msg);
+
+	//modified nested group and a route added with lengths changed
+	msg.ref<trk::GRP>().ref<trk::U16>().set(0x5678);
+	EXPECT_TRUE(msg.get<trk::GRP>().modified());
+	msg.ref<trk::ROUTE>().push_back(dctx)->set("route"sv);
+	expect_encoded(msg);
+	EXPECT_EQ(sizeof(encoded) + 7, ctx.buffer().get_offset());
+
+	//decoded again refers to the new input
+	msg.clear();
+	EXPECT_TRUE(msg.origin().empty());
+	dctx.reset(buffer, ctx.buffer().get_offset());
+	decode(med::octet_decoder{dctx}, msg);
+	EXPECT_EQ(buffer, msg.origin().data());
+	EXPECT_FALSE(msg.get<trk::GRP>().modified());
+}
+
+//writes via ref from the top through non-tracked container
+TEST(seq, tracked_nested)
+{
+	uint8_t const encoded[] = {
+		0x11,
+		7, 12, 6, 10, 1, 2, 0x12, 0x34, 2, 4, 0x01, 0x02, 0x03, 0x04,
+	};
+
+	trk::NMSG msg;
+	med::decoder_context<> dctx{ encoded };
+	decode(med::octet_decoder{dctx}, msg);
+	ASSERT_EQ(sizeof(encoded), msg.origin().size());
+
+	uint8_t buffer[64];
+	med::encoder_context<> ctx{ buffer };
+
+	//nested tracked group is re-encoded along with lengths of all enclosing
+	msg.ref<trk::MID>().ref<trk::GRP>().ref<trk::U16>().set(0x5678);
+	EXPECT_TRUE(msg.modified());
+	EXPECT_TRUE(msg.origin().empty());
+	encode(med::octet_encoder{ctx}, msg);
+	uint8_t const group[] = {
+		0x11,
+		7, 12, 6, 10, 1, 2, 0x56, 0x78, 2, 4, 0x01, 0x02, 0x03, 0x04,
+	};
+	EXPECT_STREQ(as_string(group), as_string(ctx.buffer()));
+
+	//push_back to multi-field of non-tracked container
+	dctx.reset(encoded, sizeof(encoded));
+	decode(med::octet_decoder{dctx}, msg);
+	msg.ref<trk::MID>().ref<trk::ROUTE>().push_back(dctx)->set("ab"sv);
+	EXPECT_TRUE(msg.modified());
+	EXPECT_FALSE(msg.get<trk::MID>().get<trk::GRP>().modified());
+	ctx.reset();
+	encode(med::octet_encoder{ctx}, msg);
+	uint8_t const route[] = {
+		0x11,
+		7, 16, 6, 10, 1, 2, 0x12, 0x34, 2, 4, 0x01, 0x02, 0x03, 0x04, 5, 2, 'a', 'b',
+	};
+	EXPECT_STREQ(as_string(route), as_string(ctx.buffer()));
+
+	//copy into decoded one doesn't refer to any input
+	trk::NMSG copy;
+	dctx.reset(encoded, sizeof(encoded));
+	decode(med::octet_decoder{dctx}, copy);
+	copy.copy(msg, dctx);
+	EXPECT_TRUE(copy.modified());
+	EXPECT_TRUE(copy.origin().empty());
+}
+
+//snapshots are taken from unmodified tracked message
+TEST(seq, tracked_snapshot)
+{
+	uint8_t const encoded[] = {
+		0x11,
+		3, 10, 1, 2, 0x12, 0x34, 2, 4, 0, 0, 0, 7,
+	};
+
+	trk::SMSG msg;
+	med::decoder_context<> dctx{ encoded };
+	decode(med::octet_decoder{dctx}, msg);
+	ASSERT_FALSE(msg.origin().empty());
+
+	uint8_t buffer[64];
+	size_t albuf[128];
+	med::allocator alloc{albuf};
+	med::encoder_context<med::allocator> ctx{ buffer, &alloc };
+	med::octet_encoder encoder{ctx};
+	encode(encoder, msg);
+	EXPECT_STREQ(as_string(encoded), as_string(ctx.buffer()));
+	EXPECT_FALSE(msg.modified());
+
+	trk::SEQNUM sn;
+	sn.set(8);
+	update(encoder, sn);
+	uint8_t const updated[] = {
+		0x11,
+		3, 10, 1, 2, 0x12, 0x34, 2, 4, 0, 0, 0, 8,
+	};
+	EXPECT_TRUE(Matches(updated, buffer));
+
+	med::skeleton<trk::SMSG, 64, trk::SEQNUM> sk;
+	sk.prepare(msg);
+	EXPECT_STREQ(as_string(encoded), as_string(sk.bytes()));
+
+	ctx.reset();
+	sk.emit(med::octet_encoder{ctx}, sn);
+	EXPECT_STREQ(as_string(updated), as_string(ctx.buffer()));
+}
@@ -1,5 +1,6 @@
 #include "ut.hpp"
 #include "ut_proto.hpp"
+#include "lazy_set.hpp"
 
 #if 0 //TODO! FIXME
 TEST(set, compound)
@@ -377,6 +378,12 @@ TEST(decode, set_fail)
 	};
 	ctx.reset(extra_field, sizeof(extra_field));
 	EXPECT_THROW(decode(med::octet_decoder{ctx}, proto), med::extra_ie);
+
+	//same w/o exceptions
+	ctx.reset(missing_mandatory, sizeof(missing_mandatory));
+	EXPECT_EQ(med::error::missing_ie, decode(med::octet_decoder{ctx, med::status_on_error{}}, proto).code());
+	ctx.reset(extra_field, sizeof(extra_field));
+	EXPECT_EQ(med::error::extra_ie, decode(med::octet_decoder{ctx, med::status_on_error{}}, proto).code());
 }
 
 TEST(decode, mset_ok)
@@ -604,3 +611,180 @@ TEST(decode, set_func_fail)
 	ctx.reset(encoded2);
 	EXPECT_THROW(decode(med::octet_decoder{ctx}, proto), med::extra_ie);
 }
+
+namespace many {
+
+template <std::size_t N>
+struct V : med::value<uint8_t> {};
+//sparse tags to be looked up in compile-time table
+template <std::size_t N>
+using F = O<T16<1000 + 37*N>, V<N>>;
+
+struct SET : med::set<
+	F<0>,  F<1>,  F<2>,  F<3>,  F<4>,  F<5>,  F<6>,  F<7>,
+	F<8>,  F<9>,  F<10>, F<11>, F<12>, F<13>, F<14>, F<15>
+>{};
+
+} //end: namespace many
+
+TEST(decode, set_tag_table)
+{
+	using table = med::sl::tag_table<med::octet_decoder<med::decoder_context<>>, many::F<0>, many::F<1>, many::F<15>>;
+	static_assert(table::first_unfixed == table::num_ies);
+	static_assert(0 == table::find(1000));
+	static_assert(1 == table::find(1037));
+	static_assert(2 == table::find(1000 + 37*15));
+	static_assert(table::not_found == table::find(1001));
+
+	//in reverse order of definition
+	uint8_t const encoded[] = {
+		0x06, 0x13, 15, //1000+37*15
+		0x03, 0xE8, 0, //1000
+		0x04, 0x57, 3, //1000+37*3
+	};
+	med::decoder_context<> ctx{ encoded };
+	many::SET msg;
+	decode(med::octet_decoder{ctx}, msg);
+	ASSERT_NE(nullptr, msg.get<many::V<0>>());
+	EXPECT_EQ(0, msg.get<many::V<0>>()->get());
+	ASSERT_NE(nullptr, msg.get<many::V<3>>());
+	EXPECT_EQ(3, msg.get<many::V<3>>()->get());
+	ASSERT_NE(nullptr, msg.get<many::V<15>>());
+	EXPECT_EQ(15, msg.get<many::V<15>>()->get());
+	EXPECT_EQ(nullptr, msg.get<many::V<1>>());
+
+	//unknown tag
+	uint8_t const unknown[] = { 0x03, 0xE9, 1 };
+	ctx.reset(unknown, sizeof(unknown));
+	msg.clear();
+	EXPECT_THROW(decode(med::octet_decoder{ctx}, msg), med::unknown_tag);
+}
+
+TEST(decode, set_tag_match)
+{
+	//fixed tag matching a range of values
+	struct TN : med::value<med::fixed<0xE0, uint8_t>>
+	{
+		static constexpr bool match(value_type v) { return 0xE0 == (v & 0xF0); }
+	};
+	struct A : med::value<uint8_t> {};
+	struct B : med::value<uint8_t> {};
+	struct SET : med::set<
+		O< T<1>, A >,
+		O< TN, B >
+	>{};
+
+	using table = med::sl::tag_table<med::octet_decoder<med::decoder_context<>>, O<T<1>, A>, O<TN, B>>;
+	static_assert(table::first_unfixed == 1);
+
+	uint8_t const encoded[] = { 0xE3, 7 };
+	med::decoder_context<> ctx{ encoded };
+	SET msg;
+	decode(med::octet_decoder{ctx}, msg);
+	EXPECT_EQ(nullptr, msg.get<A>());
+	ASSERT_NE(nullptr, msg.get<B>());
+	EXPECT_EQ(7, msg.get<B>()->get());
+}
+
+TEST(decode, set_lazy)
+{
+	uint8_t const encoded[] = {
+		  0, 0x22, 9, 't', 'e', 's', 't', '.', 't', 'h', 'i', 's'
+		, 0, 0x89, 0xFF, 0xFE, 0xFD, 0xFC
+		, 0, 0x0b, 0x11
+		, 0, 0x21, 2, 0x35, 0xD9
+	};
+	med::decoder_context<> ctx{ encoded };
+	med::octet_decoder decoder{ctx};
+	med::lazy_set<MSG_SET> msg;
+	decode(decoder, msg);
+
+	ASSERT_EQ(4, msg.index().size());
+	EXPECT_EQ(12, msg.index()[1].offset);
+	EXPECT_EQ(6, msg.index()[1].size);
+	EXPECT_FALSE(msg.get<FLD_UC>().is_set());
+	msg.check(decoder);
+
+	EXPECT_EQ(0x11, msg.get<FLD_UC>(decoder).get());
+	EXPECT_EQ(0x35D9, msg.get<FLD_U16>(decoder).get());
+	ASSERT_NE(nullptr, msg.get<FLD_IP>(decoder));
+	EXPECT_EQ(0xFFFEFDFC, msg.get<FLD_IP>()->get());
+	auto const* vfld1 = msg.get<VFLD1>(decoder);
+	ASSERT_NE(nullptr, vfld1);
+	EXPECT_EQ(9, vfld1->size());
+	EXPECT_TRUE(Matches("test.this", vfld1->data(), vfld1->size()));
+	EXPECT_EQ(nullptr, msg.get<FLD_U24>(decoder));
+
+	//duplicate
+	uint8_t const dup[] = { 0, 0x0b, 0x11, 0, 0x0b, 0x12 };
+	ctx.reset(dup, sizeof(dup));
+	EXPECT_THROW(decode(decoder, msg), med::extra_ie);
+
+	//failed IE isn't treated as loaded
+	uint8_t const bad[] = { 0, 0x0b, 0x11, 0, 0x21, 1, 0x35 };
+	ctx.reset(bad, sizeof(bad));
+	decode(decoder, msg);
+	EXPECT_THROW(msg.get<FLD_U16>(decoder), med::overflow);
+	EXPECT_THROW(msg.get<FLD_U16>(decoder), med::overflow);
+	msg.clear();
+	ctx.reset(bad, sizeof(bad));
+	med::octet_decoder sdecoder{ctx, med::status_on_error{}};
+	decode(sdecoder, msg);
+	msg.get<FLD_U16>(sdecoder);
+	EXPECT_EQ(med::error::overflow, sdecoder.status().code());
+	sdecoder.reset_status();
+	msg.get<FLD_U16>(sdecoder);
+	EXPECT_EQ(med::error::overflow, sdecoder.status().code());
+}
+
+TEST(set, presence)
+{
+	MSG_SET msg;
+	EXPECT_FALSE(msg.is_set());
+
+	//accessed but not set
+	msg.ref<FLD_U16>();
+	EXPECT_FALSE(msg.is_set());
+	msg.ref<FLD_U24>().set(0x123456);
+	EXPECT_TRUE(msg.is_set());
+	msg.clear<FLD_U24>();
+	EXPECT_FALSE(msg.is_set());
+
+	msg.ref<FLD_UC>().set(0x11);
+	msg.ref<FLD_U16>().set(0x35D9);
+	MSG_SET copy;
+	copy.copy(msg);
+	EXPECT_TRUE(copy.is_set());
+	EXPECT_TRUE(copy == msg);
+	msg.clear();
+	EXPECT_FALSE(msg.is_set());
+	EXPECT_FALSE(msg.get<FLD_UC>().is_set());
+	EXPECT_FALSE(msg.get<FLD_U16>().is_set());
+
+	med::decoder_context<> ctx;
+	med::octet_decoder decoder{ctx};
+
+	//all mandatory decoded
+	uint8_t const encoded[] = { 0, 0x21, 2, 0x35, 0xD9, 0, 0x0b, 0x11 };
+	ctx.reset(encoded, sizeof(encoded));
+	decode(decoder, msg);
+	EXPECT_TRUE(msg.is_set());
+	EXPECT_EQ(0x11, msg.get<FLD_UC>().get());
+	msg.clear();
+	EXPECT_FALSE(msg.get<FLD_UC>().is_set());
+
+	//mandatory accessed but not set is still missing
+	msg.ref<FLD_UC>();
+	uint8_t const missing[] = { 0, 0x21, 2, 0x35, 0xD9 };
+	ctx.reset(missing, sizeof(missing));
+	EXPECT_THROW(decode(decoder, msg), med::missing_ie);
+
+	//mandatory set before decode is kept
+	msg.clear();
+	msg.ref<FLD_UC>().set(0x22);
+	ctx.reset(missing, sizeof(missing));
+	decode(decoder, msg);
+	EXPECT_EQ(0x22, msg.get<FLD_UC>().get());
+	msg.clear();
+	EXPECT_FALSE(msg.is_set());
+}
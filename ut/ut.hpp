@@ -9,6 +9,7 @@
 
 #include <initializer_list>
 #include <source_location>
+#include <span>
 #include <string_view>
 using namespace std::string_view_literals;
 
@@ -109,6 +110,19 @@ char const* as_string(T const& buffer)
 	return sz;
 }
 
+inline char const* as_string(std::span<uint8_t const> in)
+{
+	static char sz[64*1024];
+
+	auto psz = sz, end = psz + sizeof(sz);
+	for (auto oct : in)
+	{
+		psz += std::snprintf(psz, end - psz, "%02X ", oct);
+	}
+
+	return sz;
+}
+
 inline char const* as_string(std::initializer_list<uint8_t> in)
 {
 	static char sz[64*1024];